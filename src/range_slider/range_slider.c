@@ -21,32 +21,51 @@
 
 #include "tkc/mem.h"
 #include "tkc/utils.h"
+#include "tkc/utf8.h"
 #include "base/enums.h"
 #include "base/widget_vtable.h"
 #include "base/canvas.h"
 #include "base/vgcanvas.h"
+#include "base/idle.h"
+#include "base/system_info.h"
+#include "base/window_manager.h"
 #include "widgets/view.h"
 #include "widgets/label.h"
 #include "widgets/check_button.h"
 #include "range_slider.h"
+#include "range_slider_pool.h"
+#include "range_slider_trace.h"
 #include <stdio.h>
 #include <stdbool.h>
 #include <string.h>
+#include <math.h>
+#include <float.h>
 
 typedef enum {
   kDragger1 = 0,
   kDragger2 = 1,
 } dragger_index;
 
-#define RANGE_SLIDER_ALL_WIDGET_INIT()                                                        \
-  range_slider_t* range_slider = RANGE_SLIDER(widget);                                        \
-  return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);                                 \
-  widget_t* dragger1 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_DRAGGER1, TRUE);         \
-  widget_t* dragger2 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_DRAGGER2, TRUE);         \
-  return_value_if_fail(dragger1 != NULL && dragger2 != NULL, RET_BAD_PARAMS);                 \
-  widget_t* label_value1 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_LABEL_VALUE1, TRUE); \
-  widget_t* label_value2 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_LABEL_VALUE2, TRUE); \
-  return_value_if_fail(label_value1 != NULL && label_value2 != NULL, RET_BAD_PARAMS)
+#if RANGE_SLIDER_WITH_SECOND_THUMB
+#define RANGE_SLIDER_SINGLE_THUMB(range_slider) ((range_slider)->no_use_second_dragger)
+/* 池中的控件单滑块时dragger2只是隐藏，并未销毁 */
+#define RANGE_SLIDER_DRAGGER2(range_slider) \
+  ((range_slider)->no_use_second_dragger ? NULL : (range_slider)->dragger2)
+#else
+#define RANGE_SLIDER_SINGLE_THUMB(range_slider) TRUE
+#define RANGE_SLIDER_DRAGGER2(range_slider) ((widget_t*)NULL)
+#endif /*RANGE_SLIDER_WITH_SECOND_THUMB*/
+
+static ret_t range_slider_ensure_children(widget_t* widget);
+static ret_t range_slider_set_prop_on_loading(widget_t* widget, const char* name,
+                                              const value_t* v);
+static ret_t range_slider_set_config_str(widget_t* widget, const char* str);
+static ret_t range_slider_flush_config(widget_t* widget);
+static bool_t range_slider_value_visible_changed(widget_t* widget, dragger_index dr_idx);
+
+/* 现存的控件个数，为0时移除共用的EVT_TOUCH_DOWN监听 */
+static uint32_t s_range_slider_nr = 0;
+static uint32_t s_range_slider_touch_down_id = TK_INVALID_ID;
 
 static ret_t range_slider_load_bg_image(widget_t* widget, bitmap_t* img) {
   style_t* style = widget->astyle;
@@ -59,6 +78,56 @@ static ret_t range_slider_load_bg_image(widget_t* widget, bitmap_t* img) {
   }
 }
 
+ret_t range_slider_invalidate_style_cache(widget_t* widget) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
+
+  range_slider->style_cache.valid = FALSE;
+#if RANGE_SLIDER_WITH_LABELS
+  range_slider->label_metrics.valid = FALSE;
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+  return RET_OK;
+}
+
+static const range_slider_style_cache_t* range_slider_get_style_cache(widget_t* widget) {
+  bitmap_t img;
+  color_t dragger_bg_color;
+  color_t trans = color_init(0, 0, 0, 0);
+  range_slider_style_cache_t* cache = NULL;
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL, NULL);
+  widget_t* dragger1 = range_slider->dragger1;
+  return_value_if_fail(dragger1 != NULL, NULL);
+
+  cache = &(range_slider->style_cache);
+  if (cache->valid && cache->astyle == widget->astyle && cache->state == widget->state &&
+      cache->dragger_state == dragger1->state) {
+    return cache;
+  }
+
+  cache->bg_color = style_get_color(widget->astyle, STYLE_ID_BG_COLOR, trans);
+  cache->fg_color = style_get_color(widget->astyle, STYLE_ID_FG_COLOR, trans);
+#if RANGE_SLIDER_WITH_ROUND
+  cache->round_radius = style_get_int(widget->astyle, STYLE_ID_ROUND_RADIUS, 0);
+#endif /*RANGE_SLIDER_WITH_ROUND*/
+  cache->margin = style_get_int(widget->astyle, STYLE_ID_MARGIN, 0);
+
+  cache->dragger_has_image = range_slider_load_bg_image(dragger1, &img) == RET_OK;
+#if RANGE_SLIDER_WITH_ADAPT_TO_ICON
+  cache->dragger_image_w =
+      cache->dragger_has_image ? img.w / system_info()->device_pixel_ratio : 0;
+#endif /*RANGE_SLIDER_WITH_ADAPT_TO_ICON*/
+  dragger_bg_color = style_get_color(dragger1->astyle, STYLE_ID_BG_COLOR, trans);
+  cache->no_dragger_icon = dragger_bg_color.rgba.a == 0 && !cache->dragger_has_image;
+
+  cache->astyle = widget->astyle;
+  cache->state = widget->state;
+  cache->dragger_state = dragger1->state;
+  cache->valid = TRUE;
+
+  return cache;
+}
+
 static uint32_t inline range_slider_view_get_height(widget_t* widget) {
   range_slider_t* range_slider = RANGE_SLIDER(widget);
   return_value_if_fail(range_slider != NULL, 0);
@@ -97,6 +166,43 @@ static ret_t range_slider_invalidate(widget_t* widget) {
   return widget_invalidate(widget, NULL);
 }
 
+/* 滑轨所在的区域(view)，控件内的坐标 */
+static rect_t range_slider_track_area(widget_t* widget) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  widget_t* view = range_slider->view;
+
+  return rect_init(view->x, view->y, view->w, view->h);
+}
+
+#if RANGE_SLIDER_WITH_LABELS
+/* 值label所在的区域(view下方整个宽度)，控件内的坐标 */
+static rect_t range_slider_value_label_area(widget_t* widget) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  widget_t* view = range_slider->view;
+  xy_t y = view->y + view->h;
+
+  return rect_init(0, y, widget->w, widget->h > y ? widget->h - y : 0);
+}
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+
+/* 只刷新滑轨和值label(滑块位置变化时)，两侧的范围label不变 */
+static ret_t range_slider_invalidate_track(widget_t* widget) {
+  rect_t r;
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL && range_slider->view != NULL, RET_BAD_PARAMS);
+
+  r = range_slider_track_area(widget);
+  widget_invalidate(widget, &r);
+#if RANGE_SLIDER_WITH_LABELS
+  if (range_slider->label_value1 != NULL) {
+    r = range_slider_value_label_area(widget);
+    widget_invalidate(widget, &r);
+  }
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+
+  return RET_OK;
+}
+
 static ret_t range_slider_set_bar_size(widget_t* widget, uint32_t bar_size) {
   range_slider_t* range_slider = RANGE_SLIDER(widget);
   return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
@@ -115,75 +221,185 @@ static ret_t range_slider_set_dragger_size(widget_t* widget, uint32_t dragger_si
 static uint32_t range_slider_get_dragger_size(widget_t* widget) {
   range_slider_t* range_slider = RANGE_SLIDER(widget);
   return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
-  widget_t* dragger1 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_DRAGGER1, TRUE);
-  widget_t* dragger2 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_DRAGGER2, TRUE);
-  return_value_if_fail(dragger1 != NULL && dragger2 != NULL, RET_BAD_PARAMS);
+  const range_slider_style_cache_t* cache = range_slider_get_style_cache(widget);
+  return_value_if_fail(cache != NULL, RET_BAD_PARAMS);
 
-  bitmap_t img;
   uint32_t dragger_size = range_slider->dragger_size;
   if (range_slider->auto_get_dragger_size) {
     dragger_size = range_slider_get_bar_size(widget) * 1.5f;
   }
-  if (range_slider->dragger_adapt_to_icon) {
-    float_t ratio = system_info()->device_pixel_ratio;
-    if (range_slider_load_bg_image(dragger1, &img) == RET_OK) {
-      dragger_size = img.w / ratio;
-    }
+#if RANGE_SLIDER_WITH_ADAPT_TO_ICON
+  if (range_slider->dragger_adapt_to_icon && cache->dragger_has_image) {
+    dragger_size = cache->dragger_image_w;
   }
+#endif /*RANGE_SLIDER_WITH_ADAPT_TO_ICON*/
   return dragger_size;
 }
 
+#if RANGE_SLIDER_WITH_LABELS
+/* 可选的子控件(label和dragger2)按需创建，可能不存在 */
+static ret_t range_slider_child_use_style(widget_t* child, const char* style) {
+  if (child != NULL && style != NULL) {
+    return widget_use_style(child, style);
+  }
+  return RET_OK;
+}
+
 static ret_t range_slider_set_range_label_style(widget_t* widget, const char* style) {
   range_slider_t* range_slider = RANGE_SLIDER(widget);
   return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
-  widget_t* label_min = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_LABEL_MIN, TRUE);
-  widget_t* label_max = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_LABEL_MAX, TRUE);
-  return_value_if_fail(label_min != NULL && label_max != NULL, RET_BAD_PARAMS);
-  range_slider->range_label_style = style;
-  widget_use_style(label_min, style);
-  widget_use_style(label_max, style);
+  if (range_slider->range_label_style != style) {
+    range_slider->range_label_style = tk_str_copy(range_slider->range_label_style, style);
+  }
+  range_slider_child_use_style(range_slider->label_min, style);
+  range_slider_child_use_style(range_slider->label_max, style);
   return RET_OK;
 }
 
 static ret_t range_slider_set_value_label_style(widget_t* widget, const char* style) {
   range_slider_t* range_slider = RANGE_SLIDER(widget);
   return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
-  widget_t* label_value1 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_LABEL_VALUE1, TRUE);
-  widget_t* label_value2 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_LABEL_VALUE2, TRUE);
-  return_value_if_fail(label_value1 != NULL && label_value2 != NULL, RET_BAD_PARAMS);
-  range_slider->value_label_style = style;
-  widget_use_style(label_value1, style);
-  widget_use_style(label_value2, style);
+  if (range_slider->value_label_style != style) {
+    range_slider->value_label_style = tk_str_copy(range_slider->value_label_style, style);
+  }
+  range_slider_child_use_style(range_slider->label_value1, style);
+  range_slider_child_use_style(range_slider->label_value2, style);
+  range_slider->label_metrics.valid = FALSE;
   return RET_OK;
 }
+#endif /*RANGE_SLIDER_WITH_LABELS*/
 
 static ret_t range_slider_set_dragger_style(widget_t* widget, const char* style) {
   range_slider_t* range_slider = RANGE_SLIDER(widget);
   return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
-  widget_t* dragger1 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_DRAGGER1, TRUE);
-  widget_t* dragger2 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_DRAGGER2, TRUE);
-  return_value_if_fail(dragger1 != NULL && dragger2 != NULL, RET_BAD_PARAMS);
+  widget_t* dragger1 = range_slider->dragger1;
+  return_value_if_fail(dragger1 != NULL, RET_BAD_PARAMS);
 
-  range_slider->dragger_style = style;
+  if (range_slider->dragger_style != style) {
+    range_slider->dragger_style = tk_str_copy(range_slider->dragger_style, style);
+  }
   widget_use_style(dragger1, range_slider->dragger_style);
-  widget_use_style(dragger2, range_slider->dragger_style);
-  return RET_OK;
+  if (RANGE_SLIDER_DRAGGER2(range_slider) != NULL) {
+    widget_use_style(RANGE_SLIDER_DRAGGER2(range_slider), range_slider->dragger_style);
+  }
+  return range_slider_invalidate_style_cache(widget);
+}
+
+/* 在allowed_values中查找value(lower_bound)，hint为上次的位置，命中时为O(1) */
+static uint32_t range_slider_allowed_find(range_slider_t* range_slider, double value,
+                                          uint32_t* hint) {
+  const double* values = range_slider->allowed_values;
+
+  if (*hint < range_slider->allowed_nr && values[*hint] == value) {
+    return *hint;
+  }
+  *hint = range_slider_dataset_lower_bound(values, range_slider->allowed_nr, value);
+
+  return *hint;
+}
+
+/* 取[min, max]内最近的允许值，距离相等时取较小的 */
+static double range_slider_snap_allowed(range_slider_t* range_slider, double value,
+                                        uint32_t* hint) {
+  uint32_t i = 0;
+  uint32_t first = 0;
+  uint32_t last = 0;
+  const double* values = range_slider->allowed_values;
+  uint32_t nr = range_slider->allowed_nr;
+
+  value = tk_clamp(value, range_slider->min, range_slider->max);
+  if (*hint < nr && values[*hint] == value) {
+    return value;
+  }
+
+  first = range_slider_dataset_lower_bound(values, nr, range_slider->min);
+  last = range_slider_dataset_upper_bound(values, nr, range_slider->max);
+  if (first >= last) {
+    /* 范围内没有允许值 */
+    return value;
+  }
+
+  i = first + range_slider_dataset_lower_bound(values + first, last - first, value);
+  if (i == last || (i > first && value - values[i - 1] <= values[i] - value)) {
+    i--;
+  }
+  *hint = i;
+
+  return values[i];
+}
+
+/*
+ * 与value相邻的值(dir为1时取较大的一侧)：有允许值时为相邻的允许值，否则为value ± step。
+ * 超出[min, max]或没有相邻的允许值时返回value本身。
+ */
+static double range_slider_adjacent_value(range_slider_t* range_slider, double value, int32_t dir,
+                                          uint32_t* hint) {
+  uint32_t i = 0;
+  const double* values = range_slider->allowed_values;
+
+  if (values == NULL) {
+    return value + dir * range_slider->step;
+  }
+
+  i = range_slider_allowed_find(range_slider, value, hint);
+  if (dir > 0) {
+    if (i < range_slider->allowed_nr && values[i] == value) {
+      i++;
+    }
+    if (i >= range_slider->allowed_nr || values[i] > range_slider->max) {
+      return value;
+    }
+  } else {
+    if (i == 0 || values[i - 1] < range_slider->min) {
+      return value;
+    }
+    i--;
+  }
+  *hint = i;
+
+  return values[i];
+}
+
+/* 钳位到[min, max]并按step或允许值取整，hint为该滑块在allowed_values中的位置 */
+static double range_slider_snap_value(range_slider_t* range_slider, double value, uint32_t* hint) {
+  double step = range_slider->step;
+
+  if (range_slider->allowed_values != NULL) {
+    return range_slider_snap_allowed(range_slider, value, hint);
+  }
+
+  value = tk_clamp(value, range_slider->min, range_slider->max);
+  if (step > 0) {
+    double offset = value - range_slider->min;
+    offset = tk_roundi(offset / step) * step;
+    value = range_slider->min + offset;
+    if (value > range_slider->max) {
+      /* max不在step的整数倍上时，取不超过max的那一个 */
+      value -= step;
+    }
+  }
+
+  return value;
 }
 
 static ret_t range_slider_dragger_no_collision_assure(widget_t* widget, dragger_index dr_idx,
                                                       double* value_of_this_dragger) {
   range_slider_t* range_slider = RANGE_SLIDER(widget);
   return_value_if_fail(widget != NULL && range_slider != NULL, RET_BAD_PARAMS);
-  double step = range_slider->step;
+  /* 两个值至少相隔一个step或一个允许值 */
   if (dr_idx == kDragger1) {
-    if (range_slider->no_use_second_dragger == FALSE &&
+    if (!RANGE_SLIDER_SINGLE_THUMB(range_slider) &&
         *value_of_this_dragger >= range_slider->value2) {
-      *value_of_this_dragger = range_slider->value2 - step;
+      uint32_t hint = range_slider->allowed_hint[kDragger2];
+      *value_of_this_dragger = range_slider_adjacent_value(range_slider, range_slider->value2, -1,
+                                                           &hint);
     }
   } else if (dr_idx == kDragger2) {
-    if (range_slider->no_use_second_dragger) return RET_STOP;
+    if (RANGE_SLIDER_SINGLE_THUMB(range_slider)) return RET_STOP;
     if (*value_of_this_dragger <= range_slider->value1) {
-      *value_of_this_dragger = range_slider->value1 + step;
+      uint32_t hint = range_slider->allowed_hint[kDragger1];
+      *value_of_this_dragger = range_slider_adjacent_value(range_slider, range_slider->value1, 1,
+                                                           &hint);
     }
   } else {
     printf("invaild dragger!\r\n");
@@ -192,46 +408,132 @@ static ret_t range_slider_dragger_no_collision_assure(widget_t* widget, dragger_
   return RET_OK;
 }
 
+static ret_t range_slider_publish_snapshot(range_slider_t* range_slider) {
+  range_slider_range_t range;
+
+  if (range_slider->snapshot == NULL) {
+    return RET_OK;
+  }
+
+  range.value1 = range_slider->value1;
+  range.value2 = range_slider->value2;
+  range.min = range_slider->min;
+  range.max = range_slider->max;
+
+  return range_slider_snapshot_write(range_slider->snapshot, &range);
+}
+
+/* 值改变后都会调用，顺便发布快照 */
+static ret_t range_slider_update_stats(widget_t* widget) {
+  double lo = 0;
+  double hi = 0;
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
+
+  range_slider_publish_snapshot(range_slider);
+  if (range_slider_dataset_is_empty(&range_slider->dataset)) {
+    range_slider->count_in_range = 0;
+    range_slider->sum_in_range = 0;
+    range_slider->mean_in_range = 0;
+    return RET_OK;
+  }
+
+  /* 只用一个滑块时，区间为[min, value1] */
+  if (RANGE_SLIDER_SINGLE_THUMB(range_slider)) {
+    lo = range_slider->min;
+    hi = range_slider->value1;
+  } else {
+    lo = range_slider->value1;
+    hi = range_slider->value2;
+  }
+
+  range_slider_dataset_query(&range_slider->dataset, lo, hi, &range_slider->count_in_range,
+                             &range_slider->sum_in_range);
+  range_slider->mean_in_range =
+      range_slider->count_in_range ? range_slider->sum_in_range / range_slider->count_in_range : 0;
+
+  return RET_OK;
+}
+
+/*
+ * 分发EVT_VALUE1_XXX/EVT_VALUE2_XXX，再分发携带两个值的EVT_RANGE_CHANGED。
+ * 没有监听者时widget_dispatch只是空走一遍，不必事先检查。
+ * 任何一个监听者返回RET_STOP都会返回RET_STOP(用于取消即将发生的改变)。
+ */
+static ret_t range_slider_dispatch_range_event(widget_t* widget, uint32_t dragger,
+                                               range_slider_phase_t phase, double old_value,
+                                               double new_value) {
+  range_slider_range_event_t evt;
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
+
+  memset(&evt, 0x00, sizeof(evt));
+  evt.e = event_init(EVT_RANGE_CHANGED, widget);
+  evt.e.size = sizeof(evt);
+  evt.dragger = dragger;
+  evt.phase = phase;
+  evt.old_value = old_value;
+  evt.new_value = new_value;
+  evt.value1 = range_slider->value1;
+  evt.value2 = range_slider->value2;
+
+  return widget_dispatch(widget, (event_t*)&evt);
+}
+
+static ret_t range_slider_dispatch_value_change_event(widget_t* widget, event_type_t evt_type,
+                                                      dragger_index dr_idx, double old_value,
+                                                      double new_value) {
+  ret_t ret = RET_OK;
+  value_change_event_t evt;
+  range_slider_phase_t phase = (range_slider_phase_t)((evt_type - EVT_VALUE1_WILL_CHANGE) % 3);
+  return_value_if_fail(widget != NULL, RET_BAD_PARAMS);
+
+  value_change_event_init(&evt, evt_type, widget);
+  value_set_double(&(evt.old_value), old_value);
+  value_set_double(&(evt.new_value), new_value);
+  ret = widget_dispatch(widget, (event_t*)&evt);
+
+  if (range_slider_dispatch_range_event(widget, dr_idx, phase, old_value, new_value) ==
+      RET_STOP) {
+    ret = RET_STOP;
+  }
+
+  return ret;
+}
+
 static ret_t range_slider_set_value_internal(widget_t* widget, double value, event_type_t etype,
                                              dragger_index dr_idx) {
-  double step = 0;
-  double offset = 0;
   range_slider_t* range_slider = RANGE_SLIDER(widget);
   return_value_if_fail(widget != NULL && range_slider != NULL, RET_BAD_PARAMS);
 
-  step = range_slider->step;
-  value = tk_clamp(value, range_slider->min, range_slider->max);
-  if (step > 0) {
-    offset = value - range_slider->min;
-    offset = tk_roundi(offset / step) * step;
-    value = range_slider->min + offset;
-  }
-
+  RANGE_SLIDER_TRACE_BEGIN(RANGE_SLIDER_TRACE_SET_VALUE, dr_idx);
+  value = range_slider_snap_value(range_slider, value,
+                                  range_slider->allowed_hint + (dr_idx == kDragger2 ? 1 : 0));
   range_slider_dragger_no_collision_assure(widget, dr_idx, &value);
 
   if (dr_idx == kDragger1) {
     if (range_slider->value1 != value) {
-      value_change_event_t evt;
-      value_change_event_init(&evt, etype, widget);
-      value_set_double(&(evt.old_value), range_slider->value1);
-      value_set_double(&(evt.new_value), value);
+      double old_value = range_slider->value1;
       range_slider->value1 = value;
-      widget_dispatch(widget, (event_t*)&evt);
+      range_slider_update_stats(widget);
+      range_slider_dispatch_value_change_event(widget, etype, dr_idx, old_value, value);
     }
   } else if (dr_idx == kDragger2) {
     if (range_slider->value2 != value) {
-      value_change_event_t evt;
-      value_change_event_init(&evt, etype, widget);
-      value_set_double(&(evt.old_value), range_slider->value2);
-      value_set_double(&(evt.new_value), value);
+      double old_value = range_slider->value2;
       range_slider->value2 = value;
-      widget_dispatch(widget, (event_t*)&evt);
+      range_slider_update_stats(widget);
+      range_slider_dispatch_value_change_event(widget, etype, dr_idx, old_value, value);
     }
   } else {
     printf("invaild dragger!\r\n");
+    RANGE_SLIDER_TRACE_END(RANGE_SLIDER_TRACE_SET_VALUE, dr_idx);
     return RET_STOP;
   }
-  range_slider_invalidate(widget);
+  if (range_slider_value_visible_changed(widget, dr_idx)) {
+    range_slider_invalidate(widget);
+  }
+  RANGE_SLIDER_TRACE_END(RANGE_SLIDER_TRACE_SET_VALUE, dr_idx);
   return RET_OK;
 }
 
@@ -239,10 +541,8 @@ ret_t range_slider_set_value(widget_t* widget, dragger_index dr_idx, double valu
   range_slider_t* range_slider = RANGE_SLIDER(widget);
   return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
 
-  if (dr_idx == kDragger1 && range_slider->dragger1_dragging) {
-    return RET_BUSY;
-  }
-  if (dr_idx == kDragger2 && range_slider->dragger2_dragging) {
+  if (range_slider->input_state == RANGE_SLIDER_INPUT_DRAGGING &&
+      range_slider->active_dragger == dr_idx) {
     return RET_BUSY;
   }
 
@@ -252,11 +552,8 @@ ret_t range_slider_set_value(widget_t* widget, dragger_index dr_idx, double valu
   event_type_t evt_value_changed = (dr_idx == kDragger1) ? EVT_VALUE1_CHANGED : EVT_VALUE2_CHANGED;
 
   if (*pvalue != value) {
-    value_change_event_t evt;
-    value_change_event_init(&evt, evt_value_will_change, widget);
-    value_set_uint32(&(evt.old_value), *pvalue);
-    value_set_uint32(&(evt.new_value), value);
-    if (widget_dispatch(widget, (event_t*)&evt) == RET_STOP) {
+    if (range_slider_dispatch_value_change_event(widget, evt_value_will_change, dr_idx, *pvalue,
+                                                 value) == RET_STOP) {
       return RET_OK;
     }
     return range_slider_set_value_internal(widget, value, evt_value_changed, dr_idx);
@@ -264,134 +561,573 @@ ret_t range_slider_set_value(widget_t* widget, dragger_index dr_idx, double valu
   return RET_OK;
 }
 
-ret_t range_slider_inc(widget_t* widget, dragger_index dr_idx) {
+ret_t range_slider_set_range(widget_t* widget, double value1, double value2, bool_t notify) {
   range_slider_t* range_slider = RANGE_SLIDER(widget);
   return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
-  double delta = range_slider->step ? range_slider->step : 1;
-  double* pvalue = (dr_idx == kDragger1) ? &(range_slider->value1) : &(range_slider->value2);
 
-  double new_value = *pvalue + delta;
-  if (new_value < range_slider->min) {
-    new_value = range_slider->min;
+  value1 = range_slider_snap_value(range_slider, value1, range_slider->allowed_hint + kDragger1);
+  value2 = range_slider_snap_value(range_slider, value2, range_slider->allowed_hint + 1);
+  if (!RANGE_SLIDER_SINGLE_THUMB(range_slider) && value1 > value2) {
+    value1 = value2;
   }
-  if (new_value > range_slider->max) {
-    new_value = range_slider->max;
+  if (value1 == range_slider->value1 && value2 == range_slider->value2) {
+    return RET_OK;
   }
-  return range_slider_set_value(widget, dr_idx, new_value);
+
+  range_slider->value1 = value1;
+  range_slider->value2 = value2;
+  range_slider_update_stats(widget);
+  if (range_slider_value_visible_changed(widget, kDragger1) ||
+      range_slider_value_visible_changed(widget, kDragger2)) {
+    range_slider_invalidate(widget);
+  }
+
+  return notify ? range_slider_notify_range(widget, RANGE_SLIDER_PHASE_CHANGED) : RET_OK;
 }
 
-ret_t range_slider_dec(widget_t* widget, dragger_index dr_idx) {
+ret_t range_slider_notify_range(widget_t* widget, range_slider_phase_t phase) {
+  return_value_if_fail(RANGE_SLIDER(widget) != NULL, RET_BAD_PARAMS);
+
+  return range_slider_dispatch_range_event(widget, RANGE_SLIDER_DRAGGER_BOTH, phase, 0, 0);
+}
+
+/* 滚轮或按键每次缩放的倍数和平移的比例 */
+#define RANGE_SLIDER_ZOOM_STEP 1.25
+#define RANGE_SLIDER_DEFAULT_OVERVIEW_HEIGHT 4
+#define RANGE_SLIDER_PAN_STEP 0.1
+
+/* 主滑轨当前显示的区间，返回长度，没有缩放时为[min, max] */
+static double range_slider_visible_range(range_slider_t* range_slider, double* start) {
+  if (range_slider->view_span > 0) {
+    *start = range_slider->view_start;
+    return range_slider->view_span;
+  }
+
+  *start = range_slider->min;
+  return range_slider->max - range_slider->min;
+}
+
+/* 可缩放到的最小区间：不小于step，也不小于double在该数量级上能可靠分辨的精度 */
+static double range_slider_min_span(range_slider_t* range_slider) {
+  double magnitude = tk_max(fabs(range_slider->min), fabs(range_slider->max));
+  double span = tk_max(magnitude, range_slider->max - range_slider->min) * 1e-12;
+
+  return tk_max(span, range_slider->step);
+}
+
+/* 把子区间限制在[min, max]之内，覆盖整个范围时取消缩放 */
+static ret_t range_slider_clamp_viewport(range_slider_t* range_slider) {
+  double range = range_slider->max - range_slider->min;
+
+  if (range_slider->view_span <= 0 || range_slider->view_span >= range) {
+    range_slider->view_span = 0;
+    range_slider->view_start = range_slider->min;
+  } else {
+    range_slider->view_start = tk_clamp(range_slider->view_start, range_slider->min,
+                                        range_slider->max - range_slider->view_span);
+  }
+
+  return RET_OK;
+}
+
+ret_t range_slider_set_viewport(widget_t* widget, double start, double span) {
   range_slider_t* range_slider = RANGE_SLIDER(widget);
-  return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
-  double delta = range_slider->step ? range_slider->step : 1;
-  double* pvalue = (dr_idx == kDragger1) ? &(range_slider->value1) : &(range_slider->value2);
-  double new_value = *pvalue - delta;
-  if (new_value < range_slider->min) {
-    new_value = range_slider->min;
+  return_value_if_fail(range_slider != NULL && span >= 0, RET_BAD_PARAMS);
+  double old_start = range_slider->view_start;
+  double old_span = range_slider->view_span;
+
+  if (span > 0) {
+    span = tk_max(span, range_slider_min_span(range_slider));
   }
-  if (new_value > range_slider->max) {
-    new_value = range_slider->max;
+  range_slider->view_start = start;
+  range_slider->view_span = span;
+  range_slider_clamp_viewport(range_slider);
+
+  if (range_slider->view_start == old_start && range_slider->view_span == old_span) {
+    return RET_OK;
   }
-  return range_slider_set_value(widget, dr_idx, new_value);
+
+  /* 平移和缩放只影响滑轨、概览条和值label的位置 */
+  return range_slider_invalidate_track(widget);
 }
 
-static ret_t range_slider_dispatch_value_change_event(widget_t* widget, event_type_t evt_type,
-                                                      dragger_index dr_idx, double value) {
+ret_t range_slider_zoom(widget_t* widget, double factor, double anchor) {
+  double start = 0;
+  double span = 0;
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL && factor > 0, RET_BAD_PARAMS);
+
+  span = range_slider_visible_range(range_slider, &start);
+  anchor = tk_clamp(anchor, start, start + span);
+
+  return range_slider_set_viewport(widget, anchor - (anchor - start) / factor, span / factor);
+}
+
+static ret_t range_slider_pan(widget_t* widget, double ratio) {
   range_slider_t* range_slider = RANGE_SLIDER(widget);
   return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
 
-  double* pvalue = (dr_idx == kDragger1) ? &range_slider->value1 : &range_slider->value2;
-  value_change_event_t evt;
-  value_change_event_init(&evt, evt_type, widget);
-  value_set_uint32(&(evt.old_value), *pvalue);
-  value_set_uint32(&(evt.new_value), value);
-  if (widget_dispatch(widget, (event_t*)&evt) == RET_STOP) {
+  if (range_slider->view_span <= 0) {
     return RET_OK;
   }
-  return RET_OK;
+
+  return range_slider_set_viewport(
+      widget, range_slider->view_start + range_slider->view_span * ratio, range_slider->view_span);
 }
 
-static ret_t range_slider_set_no_use_second_dragger(widget_t* widget,
-                                                    bool_t no_use_second_dragger) {
+/* 以选中区间的中点为中心缩放，中点不在显示区间内时以显示区间的中点为中心 */
+static ret_t range_slider_zoom_by_step(widget_t* widget, bool_t zoom_in) {
+  double start = 0;
+  double span = 0;
+  double anchor = 0;
   range_slider_t* range_slider = RANGE_SLIDER(widget);
   return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
-  widget_t* dragger1 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_DRAGGER1, TRUE);
-  widget_t* dragger2 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_DRAGGER2, TRUE);
-  return_value_if_fail(dragger1 != NULL && dragger2 != NULL, RET_BAD_PARAMS);
-  widget_t* label_value2 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_LABEL_VALUE2, TRUE);
-  return_value_if_fail(label_value2 != NULL, RET_BAD_PARAMS);
 
-  range_slider->no_use_second_dragger = no_use_second_dragger;
-  if (range_slider->no_use_second_dragger) {
-    widget_set_visible(dragger2, FALSE);
-    if (range_slider->value_label_visible) {
-      widget_set_visible(label_value2, FALSE);
+  span = range_slider_visible_range(range_slider, &start);
+  anchor = RANGE_SLIDER_SINGLE_THUMB(range_slider)
+               ? range_slider->value1
+               : range_slider->value1 + (range_slider->value2 - range_slider->value1) / 2;
+  if (anchor < start || anchor > start + span) {
+    anchor = start + span / 2;
+  }
+
+  return range_slider_zoom(widget, zoom_in ? RANGE_SLIDER_ZOOM_STEP : 1 / RANGE_SLIDER_ZOOM_STEP,
+                           anchor);
+}
+
+#if RANGE_SLIDER_WITH_LABELS
+/*
+ * label文本缓冲区的容量(字符数)，创建label时一次预留，之后设置文本不再分配内存。
+ * 够放合并后的两个16位的数、分隔符和数据个数，更长的文本改用widget_set_text_utf8。
+ */
+#define RANGE_SLIDER_LABEL_TEXT_CAPACITY 64
+/* 一个数按"%.1f"格式化后的最长长度：符号、DBL_MAX的309位整数、小数点、一位小数和结尾的0 */
+#define RANGE_SLIDER_NUMBER_TEXT_SIZE (DBL_MAX_10_EXP + 6)
+/* 索引模式下类别名的最长字节数，可能是中文(每个字符3个字节) */
+#define RANGE_SLIDER_INDEX_TEXT_SIZE (32 * 3)
+/* 栈上UTF-8文本的缓冲区，留出中文类别名的余量，常见的文本都放得下 */
+#define RANGE_SLIDER_LABEL_UTF8_SIZE (RANGE_SLIDER_LABEL_TEXT_CAPACITY * 2)
+/* 文本最长时的字节数：两个数(或类别名)、" – "分隔符(5个字节)和" (%u)"(13个字节)，只在截断时从堆上分配 */
+#define RANGE_SLIDER_LABEL_UTF8_MAX_SIZE \
+  (2 * tk_max(RANGE_SLIDER_NUMBER_TEXT_SIZE, RANGE_SLIDER_INDEX_TEXT_SIZE) + 5 + 13)
+/* 索引模式下缓存的文本个数，够两端和两个滑块来回拖动时使用 */
+#define RANGE_SLIDER_INDEX_CACHE_SIZE 8
+
+typedef struct _range_slider_index_entry_t {
+  /* 最近一次使用的时间，为0时表示空闲 */
+  uint32_t stamp;
+  uint32_t index;
+  char text[RANGE_SLIDER_INDEX_TEXT_SIZE];
+} range_slider_index_entry_t;
+
+typedef struct _range_slider_index_cache_t {
+  uint32_t clock;
+  range_slider_index_entry_t entries[RANGE_SLIDER_INDEX_CACHE_SIZE];
+} range_slider_index_cache_t;
+
+/* 在栈上转换为宽字符，不经过widget_set_text_utf8的临时缓冲区；放不下时不截断，交给widget_set_text_utf8 */
+static ret_t range_slider_set_label_text(widget_t* label, const char* text) {
+  uint32_t nr = 0;
+  const char* p = text;
+  wchar_t wtext[RANGE_SLIDER_LABEL_TEXT_CAPACITY];
+
+  for (p = text; *p != '\0'; p++) {
+    /* 不计UTF-8的后续字节 */
+    nr += (*p & 0xc0) != 0x80 ? 1 : 0;
+  }
+  if (nr >= ARRAY_SIZE(wtext)) {
+    return widget_set_text_utf8(label, text);
+  }
+
+  tk_utf8_to_utf16(text, wtext, ARRAY_SIZE(wtext));
+
+  return widget_set_text(label, wtext);
+}
+
+/* 索引对应的文本：先查缓存，找不到时调用回调并替换最久没用过的 */
+static const char* range_slider_index_text(range_slider_t* range_slider, double value) {
+  uint32_t i = 0;
+  uint32_t index = value > 0 ? (uint32_t)tk_roundi(value) : 0;
+  range_slider_index_cache_t* cache = range_slider->index_cache;
+  range_slider_index_entry_t* victim = NULL;
+  return_value_if_fail(cache != NULL, "");
+
+  cache->clock++;
+  victim = cache->entries;
+  for (i = 0; i < ARRAY_SIZE(cache->entries); i++) {
+    range_slider_index_entry_t* iter = cache->entries + i;
+    if (iter->stamp != 0 && iter->index == index) {
+      iter->stamp = cache->clock;
+      return iter->text;
     }
-  } else {
-    widget_set_visible(dragger2, TRUE);
-    if (range_slider->value_label_visible) {
-      widget_set_visible(label_value2, TRUE);
+    if (iter->stamp < victim->stamp) {
+      victim = iter;
     }
-    range_slider_set_value(widget, kDragger2, range_slider->value2);
   }
 
-  return range_slider_invalidate(widget);
+  victim->text[0] = '\0';
+  range_slider->index_label(range_slider->index_label_ctx, index, victim->text,
+                            sizeof(victim->text));
+  victim->text[sizeof(victim->text) - 1] = '\0';
+  victim->index = index;
+  victim->stamp = cache->clock;
+
+  return victim->text;
 }
 
-static ret_t range_slider_set_range_label_visible(widget_t* widget, bool_t visible) {
-  range_slider_t* range_slider = RANGE_SLIDER(widget);
-  return_value_if_fail(widget != NULL && range_slider != NULL, RET_BAD_PARAMS);
-  widget_t* label_min = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_LABEL_MIN, TRUE);
-  widget_t* label_max = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_LABEL_MAX, TRUE);
-  return_value_if_fail(label_min != NULL && label_max != NULL, RET_BAD_PARAMS);
-  range_slider->range_label_visible = visible;
-  widget_set_visible(label_min, visible);
-  widget_set_visible(label_max, visible);
-  return range_slider_invalidate(widget);
+/* 返回值与tk_snprintf相同，是完整文本的长度，大于等于size时表示被截断 */
+static uint32_t range_slider_format_value(range_slider_t* range_slider, double value, char* buf,
+                                          uint32_t size) {
+  int32_t len = 0;
+
+  if (range_slider->index_label != NULL) {
+    const char* text = range_slider_index_text(range_slider, value);
+    tk_strncpy(buf, text, size - 1);
+    len = strlen(text);
+  } else {
+    len = tk_snprintf(buf, size, "%.f", value);
+  }
+
+  return len > 0 ? (uint32_t)len : 0;
 }
 
-static ret_t range_slider_set_value_label_visible(widget_t* widget, bool_t visible) {
-  range_slider_t* range_slider = RANGE_SLIDER(widget);
-  return_value_if_fail(widget != NULL && range_slider != NULL, RET_BAD_PARAMS);
-  widget_t* label_value1 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_LABEL_VALUE1, TRUE);
-  widget_t* label_value2 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_LABEL_VALUE2, TRUE);
-  return_value_if_fail(label_value1 != NULL && label_value2 != NULL, RET_BAD_PARAMS);
-  range_slider->value_label_visible = visible;
-  widget_set_visible(label_value1, visible);
-  if (range_slider->no_use_second_dragger) {
-    widget_set_visible(label_value2, FALSE);
+static uint32_t range_slider_format_bound(range_slider_t* range_slider, double value,
+                                          bool_t is_min, char* buf, uint32_t size) {
+  int32_t len = 0;
+
+  if (range_slider->index_label != NULL) {
+    return range_slider_format_value(range_slider, value, buf, size);
+  } else if (is_min && range_slider->value_min_show_one_point) {
+    len = tk_snprintf(buf, size, "%.1f", value);
   } else {
-    widget_set_visible(label_value2, visible);
+    len = tk_snprintf(buf, size, "%.f", value);
   }
-  return range_slider_invalidate(widget);
+
+  return len > 0 ? (uint32_t)len : 0;
 }
 
-static ret_t range_slider_set_focusable(widget_t* widget, bool_t focusable) {
+/* 设置min/max的label文本，栈上的缓冲区放不下时才从堆上分配 */
+static ret_t range_slider_set_bound_label(range_slider_t* range_slider, widget_t* label,
+                                          double value, bool_t is_min, const char* text,
+                                          uint32_t len) {
+  ret_t ret = RET_OK;
+  char* buf = NULL;
+
+  if (len < RANGE_SLIDER_LABEL_UTF8_SIZE) {
+    return range_slider_set_label_text(label, text);
+  }
+
+  buf = TKMEM_ALLOC(RANGE_SLIDER_LABEL_UTF8_MAX_SIZE);
+  return_value_if_fail(buf != NULL, RET_OOM);
+  range_slider_format_bound(range_slider, value, is_min, buf, RANGE_SLIDER_LABEL_UTF8_MAX_SIZE);
+  ret = widget_set_text_utf8(label, buf);
+  TKMEM_FREE(buf);
+
+  return ret;
+}
+
+/* 更新一个边界的label，文本被截断时无法比较，当作有变化 */
+static ret_t range_slider_update_range_label(range_slider_t* range_slider, widget_t* label,
+                                             double value, double old_value, bool_t is_min,
+                                             bool_t force) {
+  uint32_t len = 0;
+  char text[RANGE_SLIDER_LABEL_UTF8_SIZE];
+  char old_text[RANGE_SLIDER_LABEL_UTF8_SIZE];
+
+  len = range_slider_format_bound(range_slider, value, is_min, text, sizeof(text));
+  if (!force && len < sizeof(text) &&
+      range_slider_format_bound(range_slider, old_value, is_min, old_text, sizeof(old_text)) <
+          sizeof(old_text) &&
+      tk_str_eq(text, old_text)) {
+    return RET_OK;
+  }
+
+  return range_slider_set_bound_label(range_slider, label, value, is_min, text, len);
+}
+
+/* 更新min/max的label文本，force为FALSE时只重设文本有变化的label(每次增长零点几时文本往往不变) */
+static ret_t range_slider_update_range_labels(widget_t* widget, bool_t force) {
   range_slider_t* range_slider = RANGE_SLIDER(widget);
   return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
-  widget_t* dragger1 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_DRAGGER1, TRUE);
-  widget_t* dragger2 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_DRAGGER2, TRUE);
-  return_value_if_fail(dragger1 != NULL && dragger2 != NULL, RET_BAD_PARAMS);
-  widget_set_focusable(dragger1, focusable);
-  widget_set_focusable(dragger2, focusable);
+
+  if (range_slider->label_min == NULL || range_slider->label_max == NULL) {
+    return RET_OK;
+  }
+
+  range_slider_update_range_label(range_slider, range_slider->label_min, range_slider->min,
+                                  range_slider->layout.min, TRUE, force);
+  range_slider_update_range_label(range_slider, range_slider->label_max, range_slider->max,
+                                  range_slider->layout.max, FALSE, force);
+
   return RET_OK;
 }
+#endif /*RANGE_SLIDER_WITH_LABELS*/
 
+/*
+ * 就地修改范围：钳位两个值，跟随模式下max增长时平移贴在max上的窗口。
+ * 范围只影响文本和滑轨，子控件的位置不变，因此同步布局缓存，避免重新布局，只刷新view。
+ */
+/* 值是否贴在max上：max不在step的整数倍上时，取整后的值比max小不到一个step */
+static bool_t range_slider_at_max(range_slider_t* range_slider, double value, double max) {
+  return value >= max || (range_slider->step > 0 && value > max - range_slider->step);
+}
 
-static ret_t range_slider_get_prop(widget_t* widget, const char* name, value_t* v) {
+static ret_t range_slider_apply_bounds(widget_t* widget, double min, double max) {
   range_slider_t* range_slider = RANGE_SLIDER(widget);
-  return_value_if_fail(range_slider != NULL && name != NULL && v != NULL, RET_BAD_PARAMS);
-  if (tk_str_eq(name, WIDGET_PROP_MIN)) {
-    value_set_double(v, range_slider->min);
-    return RET_OK;
-  } else if (tk_str_eq(name, WIDGET_PROP_MAX)) {
-    value_set_double(v, range_slider->max);
-    return RET_OK;
-  } else if (tk_str_eq(name, WIDGET_PROP_STEP)) {
-    value_set_double(v, range_slider->step);
+  return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
+  double old_max = range_slider->max;
+  double value1 = range_slider->value1;
+  double value2 = range_slider->value2;
+  bool_t single = RANGE_SLIDER_SINGLE_THUMB(range_slider);
+  /* 颠倒的范围会把两个值都钳到min上，选中的区间就丢了 */
+  return_value_if_fail(min <= max, RET_BAD_PARAMS);
+
+  if (min == range_slider->min && max == old_max) {
     return RET_OK;
-  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_VALUE1)) {
-    value_set_double(v, range_slider->value1);
+  }
+
+  if (range_slider->follow && max > old_max) {
+    double delta = max - old_max;
+    if (single && range_slider_at_max(range_slider, value1, old_max)) {
+      value1 = max;
+    } else if (!single && range_slider_at_max(range_slider, value2, old_max)) {
+      value1 += delta;
+      value2 = max;
+    }
+    if (range_slider->view_span > 0 &&
+        range_slider->view_start + range_slider->view_span >= old_max) {
+      range_slider->view_start += delta;
+    }
+  }
+
+  range_slider->min = min;
+  range_slider->max = max;
+  range_slider_clamp_viewport(range_slider);
+  value1 = range_slider_snap_value(range_slider, value1, range_slider->allowed_hint + kDragger1);
+  value2 = range_slider_snap_value(range_slider, value2, range_slider->allowed_hint + kDragger2);
+  if (!single && value1 > value2) {
+    value1 = value2;
+  }
+
+#if RANGE_SLIDER_WITH_LABELS
+  range_slider_update_range_labels(widget, FALSE);
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+  if (range_slider->layout.valid) {
+    range_slider->layout.min = min;
+    range_slider->layout.max = max;
+  }
+  range_slider_invalidate_track(widget);
+
+  if (value1 != range_slider->value1 || value2 != range_slider->value2) {
+    range_slider->value1 = value1;
+    range_slider->value2 = value2;
+    range_slider_update_stats(widget);
+    return range_slider_notify_range(widget, RANGE_SLIDER_PHASE_CHANGED);
+  }
+
+  return range_slider_publish_snapshot(range_slider);
+}
+
+/* 应用记下的范围，仍然颠倒时说明另一端没有跟着设置，直接丢弃 */
+static ret_t range_slider_apply_pending_bounds(widget_t* widget) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
+
+  if (range_slider->pending_min > range_slider->pending_max) {
+    log_debug("range_slider: drop inverted bounds [%g, %g]\n", range_slider->pending_min,
+              range_slider->pending_max);
+    return RET_OK;
+  }
+
+  return range_slider_apply_bounds(widget, range_slider->pending_min, range_slider->pending_max);
+}
+
+static ret_t range_slider_on_bounds_idle(const idle_info_t* info) {
+  widget_t* widget = WIDGET(info->ctx);
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL, RET_REMOVE);
+
+  range_slider->bounds_idle_id = TK_INVALID_ID;
+  range_slider_apply_pending_bounds(widget);
+
+  return RET_REMOVE;
+}
+
+static ret_t range_slider_cancel_pending_bounds(widget_t* widget) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
+
+  if (range_slider->bounds_idle_id != TK_INVALID_ID) {
+    idle_remove(range_slider->bounds_idle_id);
+    range_slider->bounds_idle_id = TK_INVALID_ID;
+  }
+
+  return RET_OK;
+}
+
+ret_t range_slider_set_bounds(widget_t* widget, double min, double max) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
+
+  if (!range_slider->follow && min <= max) {
+    range_slider_cancel_pending_bounds(widget);
+    return range_slider_apply_bounds(widget, min, max);
+  }
+
+  /*
+   * 高频更新(如每毫秒一个采样)只记录最新的范围，每帧应用一次。
+   * 颠倒的范围(如先设min再设max时的中间状态)也先记下，另一端设置后一起应用，到下一帧仍颠倒时放弃。
+   */
+  range_slider->pending_min = min;
+  range_slider->pending_max = max;
+  if (range_slider->bounds_idle_id == TK_INVALID_ID) {
+    range_slider->bounds_idle_id = idle_add(range_slider_on_bounds_idle, widget);
+  }
+
+  return RET_OK;
+}
+
+static ret_t range_slider_set_follow(widget_t* widget, bool_t follow) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
+
+  range_slider->follow = follow;
+  if (!follow && range_slider->bounds_idle_id != TK_INVALID_ID) {
+    range_slider_cancel_pending_bounds(widget);
+    return range_slider_apply_pending_bounds(widget);
+  }
+
+  return RET_OK;
+}
+
+#define RANGE_SLIDER_MIN(range_slider)                                                \
+  ((range_slider)->bounds_idle_id != TK_INVALID_ID ? (range_slider)->pending_min \
+                                                   : (range_slider)->min)
+#define RANGE_SLIDER_MAX(range_slider)                                                \
+  ((range_slider)->bounds_idle_id != TK_INVALID_ID ? (range_slider)->pending_max \
+                                                   : (range_slider)->max)
+
+#if RANGE_SLIDER_WITH_KEYBOARD
+ret_t range_slider_inc(widget_t* widget, dragger_index dr_idx) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
+  double delta = range_slider->step ? range_slider->step : 1;
+  double* pvalue = (dr_idx == kDragger1) ? &(range_slider->value1) : &(range_slider->value2);
+
+  if (range_slider->allowed_values != NULL) {
+    uint32_t* hint = range_slider->allowed_hint + (dr_idx == kDragger2 ? 1 : 0);
+    return range_slider_set_value(widget, dr_idx,
+                                  range_slider_adjacent_value(range_slider, *pvalue, 1, hint));
+  }
+
+  double new_value = *pvalue + delta;
+  if (new_value < range_slider->min) {
+    new_value = range_slider->min;
+  }
+  if (new_value > range_slider->max) {
+    new_value = range_slider->max;
+  }
+  return range_slider_set_value(widget, dr_idx, new_value);
+}
+
+ret_t range_slider_dec(widget_t* widget, dragger_index dr_idx) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
+  double delta = range_slider->step ? range_slider->step : 1;
+  double* pvalue = (dr_idx == kDragger1) ? &(range_slider->value1) : &(range_slider->value2);
+
+  if (range_slider->allowed_values != NULL) {
+    uint32_t* hint = range_slider->allowed_hint + (dr_idx == kDragger2 ? 1 : 0);
+    return range_slider_set_value(widget, dr_idx,
+                                  range_slider_adjacent_value(range_slider, *pvalue, -1, hint));
+  }
+
+  double new_value = *pvalue - delta;
+  if (new_value < range_slider->min) {
+    new_value = range_slider->min;
+  }
+  if (new_value > range_slider->max) {
+    new_value = range_slider->max;
+  }
+  return range_slider_set_value(widget, dr_idx, new_value);
+}
+#endif /*RANGE_SLIDER_WITH_KEYBOARD*/
+
+#if RANGE_SLIDER_WITH_SECOND_THUMB
+static ret_t range_slider_set_no_use_second_dragger(widget_t* widget,
+                                                    bool_t no_use_second_dragger) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
+
+  range_slider->no_use_second_dragger = no_use_second_dragger;
+  range_slider_ensure_children(widget);
+  if (!range_slider->no_use_second_dragger) {
+    range_slider_set_value(widget, kDragger2, range_slider->value2);
+  }
+  range_slider_update_stats(widget);
+
+  return range_slider_invalidate(widget);
+}
+#endif /*RANGE_SLIDER_WITH_SECOND_THUMB*/
+
+#if RANGE_SLIDER_WITH_LABELS
+static ret_t range_slider_set_range_label_visible(widget_t* widget, bool_t visible) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(widget != NULL && range_slider != NULL, RET_BAD_PARAMS);
+  range_slider->range_label_visible = visible;
+  range_slider_ensure_children(widget);
+  return range_slider_invalidate(widget);
+}
+
+static ret_t range_slider_set_value_label_visible(widget_t* widget, bool_t visible) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(widget != NULL && range_slider != NULL, RET_BAD_PARAMS);
+  range_slider->value_label_visible = visible;
+  range_slider_ensure_children(widget);
+  return range_slider_invalidate(widget);
+}
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+
+#if RANGE_SLIDER_WITH_KEYBOARD
+static ret_t range_slider_set_focusable(widget_t* widget, bool_t focusable) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
+  widget_t* dragger1 = range_slider->dragger1;
+  return_value_if_fail(dragger1 != NULL, RET_BAD_PARAMS);
+  widget_set_focusable(dragger1, focusable);
+  if (RANGE_SLIDER_DRAGGER2(range_slider) != NULL) {
+    widget_set_focusable(RANGE_SLIDER_DRAGGER2(range_slider), focusable);
+  }
+  return RET_OK;
+}
+#endif /*RANGE_SLIDER_WITH_KEYBOARD*/
+
+static ret_t range_slider_get_prop(widget_t* widget, const char* name, value_t* v) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL && name != NULL && v != NULL, RET_BAD_PARAMS);
+  if (tk_str_eq(name, WIDGET_PROP_MIN)) {
+    value_set_double(v, RANGE_SLIDER_MIN(range_slider));
+    return RET_OK;
+  } else if (tk_str_eq(name, WIDGET_PROP_MAX)) {
+    value_set_double(v, RANGE_SLIDER_MAX(range_slider));
+    return RET_OK;
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_FOLLOW)) {
+    value_set_bool(v, range_slider->follow);
+    return RET_OK;
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_VIEW_START)) {
+    value_set_double(v, range_slider->view_start);
+    return RET_OK;
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_VIEW_SPAN)) {
+    value_set_double(v, range_slider->view_span);
+    return RET_OK;
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_OVERVIEW_HEIGHT)) {
+    value_set_uint32(v, range_slider->overview_height);
+    return RET_OK;
+  } else if (tk_str_eq(name, WIDGET_PROP_STEP)) {
+    value_set_double(v, range_slider->step);
+    return RET_OK;
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_VALUE1)) {
+    value_set_double(v, range_slider->value1);
     return RET_OK;
   } else if (tk_str_eq(name, RANGE_SLIDER_PROP_VALUE2)) {
     value_set_double(v, range_slider->value2);
@@ -402,15 +1138,20 @@ static ret_t range_slider_get_prop(widget_t* widget, const char* name, value_t*
   } else if (tk_str_eq(name, RANGE_SLIDER_PROP_DRAGGER_SIZE)) {
     value_set_uint32(v, range_slider->dragger_size);
     return RET_OK;
+#if RANGE_SLIDER_WITH_ADAPT_TO_ICON
   } else if (tk_str_eq(name, RANGE_SLIDER_PROP_DRAGGER_ADAPT_TO_ICON)) {
     value_set_bool(v, range_slider->dragger_adapt_to_icon);
     return RET_OK;
+#endif /*RANGE_SLIDER_WITH_ADAPT_TO_ICON*/
   } else if (tk_str_eq(name, RANGE_SLIDER_PROP_DRAGGER_STYLE)) {
     value_set_str(v, range_slider->dragger_style);
     return RET_OK;
+#if RANGE_SLIDER_WITH_SECOND_THUMB
   } else if (tk_str_eq(name, RANGE_SLIDER_PROP_NO_USE_SECOND_DRAGGER)) {
     value_set_bool(v, range_slider->no_use_second_dragger);
     return RET_OK;
+#endif /*RANGE_SLIDER_WITH_SECOND_THUMB*/
+#if RANGE_SLIDER_WITH_LABELS
   } else if (tk_str_eq(name, RANGE_SLIDER_PROP_RANGE_LABEL_STYLE)) {
     value_set_str(v, range_slider->range_label_style);
     return RET_OK;
@@ -432,33 +1173,64 @@ static ret_t range_slider_get_prop(widget_t* widget, const char* name, value_t*
   } else if (tk_str_eq(name, RANGE_SLIDER_SUB_WIDGET_VALUE_LABEL_WIDTH)) {
     value_set_uint32(v, range_slider->value_label_width);
     return RET_OK;
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+#if RANGE_SLIDER_WITH_KEYBOARD
   } else if (tk_str_eq(name, RANGE_SLIDER_PROP_FOCUSABLE)) {
     value_set_bool(v, range_slider->range_slider_focusable);
     return RET_OK;
+#endif /*RANGE_SLIDER_WITH_KEYBOARD*/
   } else if (tk_str_eq(name, RANGE_SLIDER_PROP_VIEW_WIDTH_RATIO)) {
     value_set_double(v, range_slider->range_slider_view_width_ratio);
     return RET_OK;
   } else if (tk_str_eq(name, RANGE_SLIDER_PROP_VIEW_HEIGHT_RATIO)) {
     value_set_double(v, range_slider->range_slider_view_height_ratio);
     return RET_OK;
+#if RANGE_SLIDER_WITH_LABELS
   } else if (tk_str_eq(name, RANGE_SLIDER_PROP_VALUE_MIN_SHOW_ONE_POINT)) {
     value_set_bool(v, range_slider->value_min_show_one_point);
+    return RET_OK;
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_COUNT_LABEL_VISIBLE)) {
+    value_set_bool(v, range_slider->count_label_visible);
+    return RET_OK;
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_COUNT_IN_RANGE)) {
+    value_set_uint32(v, range_slider->count_in_range);
+    return RET_OK;
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_SUM_IN_RANGE)) {
+    value_set_double(v, range_slider->sum_in_range);
+    return RET_OK;
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_MEAN_IN_RANGE)) {
+    value_set_double(v, range_slider->mean_in_range);
+    return RET_OK;
   }
   return RET_NOT_FOUND;
 }
 
 static ret_t range_slider_set_prop(widget_t* widget, const char* name, const value_t* v) {
   range_slider_t* range_slider = RANGE_SLIDER(widget);
-  return_value_if_fail(widget != NULL && name != NULL && v != NULL, RET_BAD_PARAMS);
-  widget_t* dragger1 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_DRAGGER1, TRUE);
-  widget_t* dragger2 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_DRAGGER2, TRUE);
-  return_value_if_fail(dragger1 != NULL && dragger2 != NULL, RET_BAD_PARAMS);
-  if (tk_str_eq(name, WIDGET_PROP_MIN)) {
-    range_slider->min = value_double(v);
-    return RET_OK;
+  return_value_if_fail(range_slider != NULL && name != NULL && v != NULL, RET_BAD_PARAMS);
+  if (widget->loading) {
+    ret_t ret = range_slider_set_prop_on_loading(widget, name, v);
+    if (ret != RET_NOT_FOUND) {
+      return ret;
+    }
+  }
+
+  if (tk_str_eq(name, RANGE_SLIDER_PROP_CONFIG)) {
+    return range_slider_set_config_str(widget, value_str(v));
+  } else if (tk_str_eq(name, WIDGET_PROP_MIN)) {
+    return range_slider_set_bounds(widget, value_double(v), RANGE_SLIDER_MAX(range_slider));
   } else if (tk_str_eq(name, WIDGET_PROP_MAX)) {
-    range_slider->max = value_double(v);
-    return RET_OK;
+    return range_slider_set_bounds(widget, RANGE_SLIDER_MIN(range_slider), value_double(v));
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_FOLLOW)) {
+    return range_slider_set_follow(widget, value_bool(v));
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_VIEW_START)) {
+    return range_slider_set_viewport(widget, value_double(v), range_slider->view_span);
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_VIEW_SPAN)) {
+    return range_slider_set_viewport(widget, range_slider->view_start, value_double(v));
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_OVERVIEW_HEIGHT)) {
+    range_slider->overview_height = value_uint32(v);
+    return range_slider_invalidate(widget);
   } else if (tk_str_eq(name, WIDGET_PROP_STEP)) {
     range_slider->step = value_double(v);
     return RET_OK;
@@ -472,13 +1244,18 @@ static ret_t range_slider_set_prop(widget_t* widget, const char* name, const val
     return range_slider_set_bar_size(widget, value_uint32(v));
   } else if (tk_str_eq(name, RANGE_SLIDER_PROP_DRAGGER_SIZE)) {
     return range_slider_set_dragger_size(widget, value_uint32(v));
+#if RANGE_SLIDER_WITH_ADAPT_TO_ICON
   } else if (tk_str_eq(name, RANGE_SLIDER_PROP_DRAGGER_ADAPT_TO_ICON)) {
     range_slider->dragger_adapt_to_icon = value_bool(v);
     return RET_OK;
+#endif /*RANGE_SLIDER_WITH_ADAPT_TO_ICON*/
   } else if (tk_str_eq(name, RANGE_SLIDER_PROP_DRAGGER_STYLE)) {
     return range_slider_set_dragger_style(widget, value_str(v));
+#if RANGE_SLIDER_WITH_SECOND_THUMB
   } else if (tk_str_eq(name, RANGE_SLIDER_PROP_NO_USE_SECOND_DRAGGER)) {
     return range_slider_set_no_use_second_dragger(widget, value_bool(v));
+#endif /*RANGE_SLIDER_WITH_SECOND_THUMB*/
+#if RANGE_SLIDER_WITH_LABELS
   } else if (tk_str_eq(name, RANGE_SLIDER_PROP_RANGE_LABEL_VISIBLE)) {
     return range_slider_set_range_label_visible(widget, value_bool(v));
   } else if (tk_str_eq(name, RANGE_SLIDER_PROP_VALUE_LABEL_VISIBLE)) {
@@ -497,420 +1274,1857 @@ static ret_t range_slider_set_prop(widget_t* widget, const char* name, const val
   } else if (tk_str_eq(name, RANGE_SLIDER_SUB_WIDGET_VALUE_LABEL_WIDTH)) {
     range_slider->value_label_width = value_uint32(v);
     return RET_OK;
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+#if RANGE_SLIDER_WITH_KEYBOARD
   } else if (tk_str_eq(name, RANGE_SLIDER_PROP_FOCUSABLE)) {
     bool_t flag = value_bool(v);
     range_slider->range_slider_focusable = flag;
     range_slider_set_focusable(widget, flag);
     return RET_OK;
+#endif /*RANGE_SLIDER_WITH_KEYBOARD*/
   } else if (tk_str_eq(name, RANGE_SLIDER_PROP_VIEW_WIDTH_RATIO)) {
     range_slider->range_slider_view_width_ratio = value_double(v);
     return RET_OK;
   } else if (tk_str_eq(name, RANGE_SLIDER_PROP_VIEW_HEIGHT_RATIO)) {
     range_slider->range_slider_view_height_ratio = value_double(v);
     return RET_OK;
+#if RANGE_SLIDER_WITH_LABELS
   } else if (tk_str_eq(name, RANGE_SLIDER_PROP_VALUE_MIN_SHOW_ONE_POINT)) {
     range_slider->value_min_show_one_point = value_bool(v);
     return RET_OK;
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_COUNT_LABEL_VISIBLE)) {
+    range_slider->count_label_visible = value_bool(v);
+    return range_slider_invalidate(widget);
+#endif /*RANGE_SLIDER_WITH_LABELS*/
   }
 
   return RET_NOT_FOUND;
 }
 
-static ret_t on_dragger_key_down(void* ctx, event_t* e) {
-  range_slider_t* range_slider = RANGE_SLIDER(ctx);
-  return_value_if_fail(ctx != NULL && e != NULL && e->target != NULL, RET_BAD_PARAMS);
-  widget_t* dragger = WIDGET(e->target);
-  return_value_if_fail(dragger != NULL, RET_BAD_PARAMS);
-  bool dragger_selected = widget_get_prop_bool(dragger, "value", false);
-
-  key_event_t* evt = (key_event_t*)e;
-  ret_t ret = RET_OK;
-  /* 按钮enter默认不会冒泡到父控件，需手动处理 */
-  widget_dispatch((widget_t*)range_slider, e);
-  if (dragger_selected && (evt->key == TK_KEY_LEFT || evt->key == TK_KEY_RIGHT)) {
-    ret = RET_STOP;  //用于阻止后继的焦点切换操作
-  }
-  if (dragger_selected && evt->key == TK_KEY_ESCAPE) {
-    ret = RET_STOP;
+#if RANGE_SLIDER_WITH_KEYBOARD
+/* 取消滑块的选中状态，通过check_button的EVT_VALUE_CHANGED同步输入状态 */
+static ret_t range_slider_release_dragger(widget_t* dragger) {
+  if (dragger != NULL && CHECK_BUTTON(dragger)->value) {
+    return widget_set_prop_bool(dragger, WIDGET_PROP_VALUE, FALSE);
   }
-  return ret;
+  return RET_OK;
 }
 
-static ret_t range_slider_on_destroy(widget_t* widget) {
-  range_slider_t* range_slider = RANGE_SLIDER(widget);
-  return_value_if_fail(widget != NULL && range_slider != NULL, RET_BAD_PARAMS);
+/* 拖动结束或选中状态改变后，根据滑块自身的状态确定输入状态 */
+static ret_t range_slider_sync_input_state(range_slider_t* range_slider, widget_t* dragger,
+                                           dragger_index dr_idx) {
+  if (CHECK_BUTTON(dragger)->value) {
+    range_slider->input_state = RANGE_SLIDER_INPUT_GRABBED;
+    range_slider->active_dragger = dr_idx;
+  } else if (dragger->focused) {
+    range_slider->input_state = RANGE_SLIDER_INPUT_FOCUSED;
+    range_slider->active_dragger = dr_idx;
+  } else if (range_slider->active_dragger == dr_idx) {
+    range_slider->input_state = RANGE_SLIDER_INPUT_IDLE;
+  }
 
   return RET_OK;
 }
 
-static xy_t range_slider_value_to_dragger_x(widget_t* widget, double value) {
+/*
+ * 滑块的焦点和选中状态变化时更新输入状态，按键处理时只读取状态，不再查询属性。
+ * 拖动过程中不切换状态，拖动结束时再同步。
+ */
+static ret_t on_dragger_state_changed(void* ctx, event_t* e) {
+  widget_t* widget = WIDGET(ctx);
   range_slider_t* range_slider = RANGE_SLIDER(widget);
-  return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
-  uint32_t dragger_size = range_slider_get_dragger_size(widget);
-  double fvalue = (value - range_slider->min) / (range_slider->max - range_slider->min);
-  int32_t margin =
-      range_slider->no_dragger_icon ? 0 : style_get_int(widget->astyle, STYLE_ID_MARGIN, 0);
+  return_value_if_fail(range_slider != NULL && e != NULL && e->target != NULL, RET_BAD_PARAMS);
+  widget_t* dragger = WIDGET(e->target);
+  dragger_index dr_idx = (dragger == RANGE_SLIDER_DRAGGER2(range_slider)) ? kDragger2 : kDragger1;
 
-  xy_t res_x = 0;
-  if (range_slider->no_dragger_icon) {
-    res_x = range_slider_view_get_width(widget) * fvalue - (dragger_size >> 1);
-  } else {
-    res_x = margin + (range_slider_view_get_width(widget) - dragger_size - (margin << 1)) * fvalue;
+  if (range_slider->input_state == RANGE_SLIDER_INPUT_DRAGGING) {
+    return RET_OK;
   }
 
-  return res_x;
-}
-
-static ret_t range_slider_update_dragger_rect(widget_t* widget, widget_t* dragger) {
-  range_slider_t* range_slider = RANGE_SLIDER(widget);
-  return_value_if_fail(range_slider != NULL && dragger != NULL, RET_BAD_PARAMS);
-  widget_t* dragger1 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_DRAGGER1, TRUE);
-  widget_t* dragger2 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_DRAGGER2, TRUE);
-  return_value_if_fail(dragger1 != NULL && dragger2 != NULL, RET_BAD_PARAMS);
-  uint32_t dragger_size = range_slider_get_dragger_size(widget);
-
-  if (dragger == dragger1) {
-    dragger->x = range_slider_value_to_dragger_x(widget, range_slider->value1);
-  } else if (dragger == dragger2) {
-    dragger->x = range_slider_value_to_dragger_x(widget, range_slider->value2);
+  if (e->type == EVT_BLUR) {
+    /* 失去焦点后方向键不再作用于该滑块，同时取消选中 */
+    range_slider_release_dragger(dragger);
+    if (range_slider->active_dragger == dr_idx) {
+      range_slider->input_state = RANGE_SLIDER_INPUT_IDLE;
+    }
+  } else {
+    range_slider_sync_input_state(range_slider, dragger, dr_idx);
   }
 
-  dragger->y = 0;
-  dragger->w = dragger_size;
-  dragger->h = range_slider_view_get_height(widget);
   return RET_OK;
 }
 
-static ret_t range_slider_get_bar_rect(widget_t* widget, rect_t* br, rect_t* fr1, rect_t* fr2) {
+/* +/-缩放，PageUp/PageDown平移(只在已放大时)，zoomable为FALSE时都不处理 */
+static ret_t range_slider_on_view_key(widget_t* widget, uint32_t key, bool_t zoomable) {
   range_slider_t* range_slider = RANGE_SLIDER(widget);
-  return_value_if_fail(range_slider != NULL && br != NULL && fr1 != NULL && fr2 != NULL,
-                       RET_BAD_PARAMS);
-  widget_t* dragger1 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_DRAGGER1, TRUE);
-  widget_t* dragger2 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_DRAGGER2, TRUE);
-  return_value_if_fail(dragger1 != NULL && dragger2 != NULL, RET_BAD_PARAMS);
-  widget_t* range_slider_view = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_VIEW, TRUE);
-  return_value_if_fail(range_slider_view != NULL, RET_BAD_PARAMS);
-
-  uint32_t bar_size = range_slider_get_bar_size(widget);
-  rect_t* dr1 = (rect_t*)dragger1;
-  rect_t* dr2 = (rect_t*)dragger2;
+  return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
 
-  /* fill background */
-  bar_size = tk_min(bar_size, range_slider_view->h);
-  br->x = 0;
-  br->h = bar_size;
-  br->w = range_slider_view->w;
-  br->y = (range_slider_view->h - bar_size) / 2;
+  if (!zoomable) {
+    return RET_OK;
+  }
 
-  /* fill foreground of value1 */
-  fr1->x = br->x;
-  fr1->y = br->y;
-  fr1->w = dr1->x - br->x + (dr1->w >> 1);
-  fr1->h = br->h;
-  /* fill foreground of value2 */
-  fr2->x = dr2->x + (dr2->w >> 1);
-  fr2->y = br->y;
-  fr2->w = range_slider_view->w - dr2->x - (dr2->w >> 1);
-  fr2->h = br->h;
+  if (key == TK_KEY_PLUS || key == TK_KEY_EQUAL || key == TK_KEY_MINUS) {
+    range_slider_zoom_by_step(widget, key != TK_KEY_MINUS);
+    return RET_STOP;
+  } else if ((key == TK_KEY_PAGEUP || key == TK_KEY_PAGEDOWN) && range_slider->view_span > 0) {
+    range_slider_pan(widget, key == TK_KEY_PAGEUP ? -RANGE_SLIDER_PAN_STEP : RANGE_SLIDER_PAN_STEP);
+    return RET_STOP;
+  }
 
-  br->x += range_slider_view_get_x(widget);
-  fr1->x += range_slider_view_get_x(widget);
-  fr2->x += range_slider_view_get_x(widget);
   return RET_OK;
 }
 
-static ret_t range_slider_fill_rect(widget_t* widget, canvas_t* c, rect_t* rect, rect_t* br,
-                                    bool is_fg) {
+/*
+ * 焦点在滑块上时按键首先到达滑块，在这里按输入状态统一处理，不再转发给range_slider。
+ * 滑块被选中时左右键调整值，ESC取消选中，+/-缩放，返回RET_STOP阻止后继的焦点切换。
+ * 未选中时只有已经放大过才处理缩放和平移，其余按键留给父控件和应用的快捷键。
+ */
+static ret_t on_dragger_key_down(void* ctx, event_t* e) {
+  ret_t ret = RET_OK;
+  widget_t* widget = WIDGET(ctx);
+  key_event_t* evt = (key_event_t*)e;
   range_slider_t* range_slider = RANGE_SLIDER(widget);
-  return_value_if_fail(range_slider != NULL && c != NULL, RET_BAD_PARAMS);
-  const char* color_key = is_fg ? STYLE_ID_FG_COLOR : STYLE_ID_BG_COLOR;
-
-  style_t* style = widget->astyle;
-  color_t trans = color_init(0, 0, 0, 0);
-  uint32_t radius = style_get_int(style, STYLE_ID_ROUND_RADIUS, 0);
-
-  color_t color = style_get_color(style, color_key, trans);
-  if (color.rgba.a && rect->w > 0 && rect->h > 0) {
-    canvas_set_fill_color(c, color);
-    if (radius > 3) {
-      ret_t ret = canvas_fill_rounded_rect(c, rect, br, &color, radius);
-      // 对于底层背景bar, 若圆角直径大于 rect 矩形的宽高, 会返回RET_FAIL, 此时需要按无圆角矩形的方法填充
-      if (ret != RET_OK) {
-        canvas_fill_rect(c, rect->x, rect->y, rect->w, rect->h);
+  return_value_if_fail(range_slider != NULL && e != NULL, RET_BAD_PARAMS);
+
+  switch (range_slider->input_state) {
+    case RANGE_SLIDER_INPUT_GRABBED: {
+      dragger_index dr_idx = (dragger_index)range_slider->active_dragger;
+      if (evt->key == TK_KEY_LEFT) {
+        range_slider_dec(widget, dr_idx);
+        ret = RET_STOP;
+      } else if (evt->key == TK_KEY_RIGHT) {
+        range_slider_inc(widget, dr_idx);
+        ret = RET_STOP;
+      } else if (evt->key == TK_KEY_ESCAPE) {
+        range_slider_release_dragger(dr_idx == kDragger1 ? range_slider->dragger1
+                                                          : RANGE_SLIDER_DRAGGER2(range_slider));
+        ret = RET_STOP;
+      } else {
+        ret = range_slider_on_view_key(widget, evt->key, TRUE);
       }
-    } else {
-      canvas_fill_rect(c, rect->x, rect->y, rect->w, rect->h);
+      break;
+    }
+    default: {
+      ret = range_slider_on_view_key(widget, evt->key, range_slider->view_span > 0);
+      break;
     }
   }
-  return RET_OK;
+
+  return ret;
 }
+#endif /*RANGE_SLIDER_WITH_KEYBOARD*/
 
-static ret_t range_slider_check_on_dragger_icon(widget_t* widget) {
+static widget_t* range_slider_create_dragger(widget_t* widget, const char* name) {
   range_slider_t* range_slider = RANGE_SLIDER(widget);
-  return_value_if_fail(widget != NULL, RET_BAD_PARAMS);
-  widget_t* dragger = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_DRAGGER1, TRUE);
-  return_value_if_fail(dragger != NULL, RET_BAD_PARAMS);
-  widget_t* range_slider_view = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_VIEW, TRUE);
-  return_value_if_fail(range_slider_view != NULL, RET_BAD_PARAMS);
+  return_value_if_fail(range_slider != NULL && range_slider->view != NULL, NULL);
+  widget_t* dragger = check_button_create_radio(range_slider->view, 0, 0, 0, 0);
+  return_value_if_fail(dragger != NULL, NULL);
+
+  widget_set_name(dragger, name);
+  /* 内部子控件不参与克隆和序列化 */
+  dragger->auto_created = TRUE;
+  if (range_slider->dragger_style != NULL) {
+    widget_use_style(dragger, range_slider->dragger_style);
+  }
+#if RANGE_SLIDER_WITH_KEYBOARD
+  if (range_slider->dragger1 != NULL) {
+    widget_set_focusable(dragger, range_slider->dragger1->focusable);
+  }
+  widget_on(dragger, EVT_KEY_DOWN, on_dragger_key_down, widget);
+  widget_on(dragger, EVT_VALUE_CHANGED, on_dragger_state_changed, widget);
+  widget_on(dragger, EVT_FOCUS, on_dragger_state_changed, widget);
+  widget_on(dragger, EVT_BLUR, on_dragger_state_changed, widget);
+#endif /*RANGE_SLIDER_WITH_KEYBOARD*/
 
-  bitmap_t img;
-  style_t* style = dragger->astyle;
-  color_t trans = color_init(0, 0, 0, 0);
-  ret_t ret = range_slider_load_bg_image(dragger, &img);
-  color_t color = style_get_color(style, STYLE_ID_BG_COLOR, trans);
-  if (color.rgba.a == 0 && ret != RET_OK) {
-    range_slider->no_dragger_icon = TRUE;
-  } else {
-    range_slider->no_dragger_icon = FALSE;
+  return dragger;
+}
+
+#if RANGE_SLIDER_WITH_LABELS
+static widget_t* range_slider_create_label(widget_t* widget, const char* name, const char* style,
+                                           const char* align) {
+  widget_t* label = label_create(widget, 0, 0, 0, 0);
+  return_value_if_fail(label != NULL, NULL);
+
+  widget_set_name(label, name);
+  label->auto_created = TRUE;
+  wstr_extend(&(label->text), RANGE_SLIDER_LABEL_TEXT_CAPACITY);
+  if (style != NULL) {
+    widget_use_style(label, style);
   }
-  return RET_OK;
+  if (align != NULL) {
+    /* text_align_h 定死，只需在创建时设置一次 */
+    widget_set_style_str(label, "normal:text_align_h", align);
+    widget_set_style_str(label, "focused:text_align_h", align);
+    widget_set_style_str(label, "disabled:text_align_h", align);
+  }
+
+  return label;
 }
+#endif /*RANGE_SLIDER_WITH_LABELS*/
 
-static ret_t range_slider_update_label(widget_t* widget, rect_t* fr1, rect_t* fr2) {
+#if RANGE_SLIDER_WITH_LABELS || RANGE_SLIDER_WITH_SECOND_THUMB
+/* 池中的控件不能释放内存，不需要的子控件只隐藏 */
+static bool_t range_slider_drop_child(range_slider_t* range_slider, widget_t** child) {
+  if (*child == NULL) {
+    return FALSE;
+  }
+
+  if (range_slider->pool != NULL) {
+    if (!(*child)->visible) {
+      return FALSE;
+    }
+    widget_set_visible(*child, FALSE);
+  } else {
+    widget_destroy(*child);
+    *child = NULL;
+  }
+
+  return TRUE;
+}
+
+static bool_t range_slider_show_child(widget_t* child) {
+  if (child != NULL && !child->visible) {
+    widget_set_visible(child, TRUE);
+    return TRUE;
+  }
+  return FALSE;
+}
+#endif /*RANGE_SLIDER_WITH_LABELS || RANGE_SLIDER_WITH_SECOND_THUMB*/
+
+/*
+ * dragger2和label只在需要时创建，不需要时销毁(池中的控件只隐藏)：
+ * 单滑块或不显示label的控件不必为用不到的子控件付出内存和遍历的开销。
+ * 加载过程中属性还不完整，推迟到布局或绘制时再处理。
+ */
+static ret_t range_slider_ensure_children(widget_t* widget) {
+  bool_t changed = FALSE;
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
+
+  if (widget->loading || range_slider->view == NULL) {
+    return RET_OK;
+  }
+
+#if RANGE_SLIDER_WITH_SECOND_THUMB
+  if (range_slider->no_use_second_dragger) {
+    if (range_slider->dragger2 != NULL && range_slider->active_dragger == kDragger2) {
+      if (range_slider->input_state == RANGE_SLIDER_INPUT_DRAGGING) {
+        widget_ungrab(range_slider->view, range_slider->dragger2);
+      }
+      range_slider->input_state = RANGE_SLIDER_INPUT_IDLE;
+      range_slider->active_dragger = kDragger1;
+    }
+    range_slider->touches[kDragger2].active = FALSE;
+    range_slider->touches[kDragger2].pending = FALSE;
+    changed = range_slider_drop_child(range_slider, &(range_slider->dragger2)) || changed;
+  } else if (range_slider->dragger2 == NULL) {
+    range_slider->dragger2 = range_slider_create_dragger(widget, RANGE_SLIDER_SUB_WIDGET_DRAGGER2);
+    changed = TRUE;
+  } else {
+    changed = range_slider_show_child(range_slider->dragger2) || changed;
+  }
+#endif /*RANGE_SLIDER_WITH_SECOND_THUMB*/
+
+#if RANGE_SLIDER_WITH_LABELS
+  if (range_slider->range_label_visible) {
+    if (range_slider->label_min == NULL) {
+      range_slider->label_min = range_slider_create_label(
+          widget, RANGE_SLIDER_SUB_WIDGET_LABEL_MIN, range_slider->range_label_style, "right");
+      changed = TRUE;
+    } else {
+      changed = range_slider_show_child(range_slider->label_min) || changed;
+    }
+    if (range_slider->label_max == NULL) {
+      range_slider->label_max = range_slider_create_label(
+          widget, RANGE_SLIDER_SUB_WIDGET_LABEL_MAX, range_slider->range_label_style, "left");
+      changed = TRUE;
+    } else {
+      changed = range_slider_show_child(range_slider->label_max) || changed;
+    }
+  } else {
+    changed = range_slider_drop_child(range_slider, &(range_slider->label_min)) || changed;
+    changed = range_slider_drop_child(range_slider, &(range_slider->label_max)) || changed;
+  }
+
+  if (range_slider->value_label_visible) {
+    if (range_slider->label_value1 == NULL) {
+      range_slider->label_value1 = range_slider_create_label(
+          widget, RANGE_SLIDER_SUB_WIDGET_LABEL_VALUE1, range_slider->value_label_style, NULL);
+      changed = TRUE;
+    } else {
+      changed = range_slider_show_child(range_slider->label_value1) || changed;
+    }
+  } else {
+    changed = range_slider_drop_child(range_slider, &(range_slider->label_value1)) || changed;
+  }
+
+  if (range_slider->value_label_visible && !RANGE_SLIDER_SINGLE_THUMB(range_slider)) {
+    if (range_slider->label_value2 == NULL) {
+      range_slider->label_value2 = range_slider_create_label(
+          widget, RANGE_SLIDER_SUB_WIDGET_LABEL_VALUE2, range_slider->value_label_style, NULL);
+      changed = TRUE;
+    } else {
+      changed = range_slider_show_child(range_slider->label_value2) || changed;
+    }
+  } else {
+    changed = range_slider_drop_child(range_slider, &(range_slider->label_value2)) || changed;
+  }
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+
+  if (changed) {
+    memset(&(range_slider->layout), 0x00, sizeof(range_slider->layout));
+#if RANGE_SLIDER_WITH_LABELS
+    memset(range_slider->label_texts, 0x00, sizeof(range_slider->label_texts));
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+    widget_set_need_relayout_children(widget);
+  }
+
+  return RET_OK;
+}
+
+static ret_t range_slider_on_destroy(widget_t* widget) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(widget != NULL && range_slider != NULL, RET_BAD_PARAMS);
+
+  if (range_slider->touch_idle_id != TK_INVALID_ID) {
+    idle_remove(range_slider->touch_idle_id);
+    range_slider->touch_idle_id = TK_INVALID_ID;
+  }
+  range_slider_cancel_pending_bounds(widget);
+  if (window_manager() != NULL) {
+    widget_off_by_ctx(window_manager(), widget);
+  }
+  if (s_range_slider_nr > 0 && --s_range_slider_nr == 0 &&
+      s_range_slider_touch_down_id != TK_INVALID_ID) {
+    if (window_manager() != NULL) {
+      widget_off(window_manager(), s_range_slider_touch_down_id);
+    }
+    s_range_slider_touch_down_id = TK_INVALID_ID;
+  }
+
+  TKMEM_FREE(range_slider->dragger_style);
+#if RANGE_SLIDER_WITH_LABELS
+  TKMEM_FREE(range_slider->range_label_style);
+  TKMEM_FREE(range_slider->value_label_style);
+  TKMEM_FREE(range_slider->index_cache);
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+
+  return RET_OK;
+}
+
+static xy_t range_slider_value_to_dragger_x(widget_t* widget, double value) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
+  const range_slider_style_cache_t* cache = range_slider_get_style_cache(widget);
+  return_value_if_fail(cache != NULL, RET_BAD_PARAMS);
+  uint32_t dragger_size = range_slider_get_dragger_size(widget);
+  double start = 0;
+  double span = range_slider_visible_range(range_slider, &start);
+  /* 先相减再缩放，数量级很大(如1e12)时也不丢失子区间内的精度；不在显示区间内的值贴在两端 */
+  double fvalue = span > 0 ? tk_clamp((value - start) / span, 0.0, 1.0) : 0;
+  int32_t margin = range_slider->no_dragger_icon ? 0 : cache->margin;
+
+  xy_t res_x = 0;
+  if (range_slider->no_dragger_icon) {
+    res_x = range_slider_view_get_width(widget) * fvalue - (dragger_size >> 1);
+  } else {
+    res_x = margin + (range_slider_view_get_width(widget) - dragger_size - (margin << 1)) * fvalue;
+  }
+
+  return res_x;
+}
+
+static ret_t range_slider_update_dragger_rect(widget_t* widget, widget_t* dragger) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL && dragger != NULL, RET_BAD_PARAMS);
+  uint32_t dragger_size = range_slider_get_dragger_size(widget);
+
+  if (dragger == range_slider->dragger1) {
+    dragger->x = range_slider_value_to_dragger_x(widget, range_slider->value1);
+  } else if (dragger == RANGE_SLIDER_DRAGGER2(range_slider)) {
+    dragger->x = range_slider_value_to_dragger_x(widget, range_slider->value2);
+  }
+
+  dragger->y = 0;
+  dragger->w = dragger_size;
+  dragger->h = range_slider_view_get_height(widget);
+  return RET_OK;
+}
+
+#if RANGE_SLIDER_WITH_LABELS
+/* 两个值格式化后的文本是否不同，被截断时无法比较，当作不同 */
+static bool_t range_slider_value_text_changed(range_slider_t* range_slider, double value,
+                                              double old_value, char* text, char* old_text,
+                                              uint32_t size) {
+  if (range_slider_format_value(range_slider, value, text, size) >= size ||
+      range_slider_format_value(range_slider, old_value, old_text, size) >= size) {
+    return TRUE;
+  }
+
+  return !tk_str_eq(text, old_text);
+}
+
+/* 值label的文本与上次显示的是否不同 */
+static bool_t range_slider_value_label_changed(range_slider_t* range_slider, widget_t* label,
+                                               uint32_t index) {
+  char text[RANGE_SLIDER_LABEL_UTF8_SIZE];
+  char shown_text[RANGE_SLIDER_LABEL_UTF8_SIZE];
+  const range_slider_label_text_t* shown = range_slider->label_texts + index;
+  double value = index == 0 ? range_slider->value1 : range_slider->value2;
+
+  /* 合并显示时另一个label宽度为0 */
+  if (label == NULL || !label->visible || label->w == 0) {
+    return FALSE;
+  }
+  if (!shown->valid || (shown->with_count && shown->count != range_slider->count_in_range)) {
+    return TRUE;
+  }
+  if (shown->merged && shown->value2 != range_slider->value2 &&
+      range_slider_value_text_changed(range_slider, range_slider->value2, shown->value2, text,
+                                      shown_text, sizeof(text))) {
+    return TRUE;
+  }
+  if (shown->value == value) {
+    return FALSE;
+  }
+
+  return range_slider_value_text_changed(range_slider, value, shown->value, text, shown_text,
+                                         sizeof(text));
+}
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+
+/*
+ * 值改变后屏幕上的内容是否变化：滑块和两段前景都由滑块按像素取整的位置决定，label比较格式化后的文本。
+ * 范围相对滑轨很大时(如500像素上的0~100000)，多数改变既不移动滑块也不改变文本，不必刷新。
+ */
+static bool_t range_slider_value_visible_changed(widget_t* widget, dragger_index dr_idx) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  widget_t* dragger = NULL;
+  double value = 0;
+  return_value_if_fail(range_slider != NULL, TRUE);
+
+  /* 还没有布局，屏幕上没有可比较的内容 */
+  if (!range_slider->layout.valid || range_slider->view == NULL || range_slider->view->w == 0) {
+    return TRUE;
+  }
+
+  dragger = dr_idx == kDragger1 ? range_slider->dragger1 : RANGE_SLIDER_DRAGGER2(range_slider);
+  value = dr_idx == kDragger1 ? range_slider->value1 : range_slider->value2;
+  if (dragger != NULL && dragger->x != range_slider_value_to_dragger_x(widget, value)) {
+    return TRUE;
+  }
+
+#if RANGE_SLIDER_WITH_LABELS
+  /* 数据个数可能显示在另一个label上，两个都要比较 */
+  return range_slider_value_label_changed(range_slider, range_slider->label_value1, 0) ||
+         range_slider_value_label_changed(range_slider, range_slider->label_value2, 1);
+#else
+  return FALSE;
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+}
+
+static ret_t range_slider_get_bar_rect(widget_t* widget, rect_t* br, rect_t* fr1, rect_t* fr2) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL && br != NULL && fr1 != NULL && fr2 != NULL,
+                       RET_BAD_PARAMS);
+  widget_t* dragger1 = range_slider->dragger1;
+  widget_t* dragger2 = RANGE_SLIDER_DRAGGER2(range_slider);
+  return_value_if_fail(dragger1 != NULL, RET_BAD_PARAMS);
+  widget_t* range_slider_view = range_slider->view;
+  return_value_if_fail(range_slider_view != NULL, RET_BAD_PARAMS);
+
+  uint32_t bar_size = range_slider_get_bar_size(widget);
+  rect_t* dr1 = (rect_t*)dragger1;
+
+  /* fill background */
+  bar_size = tk_min(bar_size, range_slider_view->h);
+  br->x = 0;
+  br->h = bar_size;
+  br->w = range_slider_view->w;
+  br->y = (range_slider_view->h - bar_size) / 2;
+
+  /* fill foreground of value1 */
+  fr1->x = br->x;
+  fr1->y = br->y;
+  fr1->w = dr1->x - br->x + (dr1->w >> 1);
+  fr1->h = br->h;
+  /* fill foreground of value2 */
+  if (dragger2 != NULL) {
+    rect_t* dr2 = (rect_t*)dragger2;
+    fr2->x = dr2->x + (dr2->w >> 1);
+    fr2->w = range_slider_view->w - dr2->x - (dr2->w >> 1);
+  } else {
+    fr2->x = br->w;
+    fr2->w = 0;
+  }
+  fr2->y = br->y;
+  fr2->h = br->h;
+
+  br->x += range_slider_view_get_x(widget);
+  fr1->x += range_slider_view_get_x(widget);
+  fr2->x += range_slider_view_get_x(widget);
+  return RET_OK;
+}
+
+static ret_t range_slider_fill_rect(widget_t* widget, canvas_t* c, rect_t* rect, rect_t* br,
+                                    bool is_fg) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL && c != NULL, RET_BAD_PARAMS);
+  const range_slider_style_cache_t* cache = range_slider_get_style_cache(widget);
+  return_value_if_fail(cache != NULL, RET_BAD_PARAMS);
+
+  color_t color = is_fg ? cache->fg_color : cache->bg_color;
+  if (color.rgba.a && rect->w > 0 && rect->h > 0) {
+    range_slider->track_draw_calls++;
+    canvas_set_fill_color(c, color);
+#if RANGE_SLIDER_WITH_ROUND
+    if (cache->round_radius > 3) {
+      ret_t ret = canvas_fill_rounded_rect(c, rect, br, &color, cache->round_radius);
+      // 对于底层背景bar, 若圆角直径大于 rect 矩形的宽高, 会返回RET_FAIL, 此时需要按无圆角矩形的方法填充
+      if (ret == RET_OK) {
+        return RET_OK;
+      }
+    }
+#endif /*RANGE_SLIDER_WITH_ROUND*/
+    canvas_fill_rect(c, rect->x, rect->y, rect->w, rect->h);
+  }
+  return RET_OK;
+}
+
+#ifdef WITH_NANOVG_GPU
+/* 把矩形加入路径，round_left/round_right指定左右两端是否为圆角 */
+static ret_t range_slider_vg_add_segment(vgcanvas_t* vg, const rect_t* r, float_t radius,
+                                         bool_t round_left, bool_t round_right) {
+  float_t x = r->x;
+  float_t y = r->y;
+  float_t w = r->w;
+  float_t h = r->h;
+  float_t max_radius = tk_min(h / 2, (round_left && round_right) ? w / 2 : w);
+  float_t rl = round_left ? tk_min(radius, max_radius) : 0;
+  float_t rr = round_right ? tk_min(radius, max_radius) : 0;
+
+  vgcanvas_move_to(vg, x + rl, y);
+  vgcanvas_line_to(vg, x + w - rr, y);
+  if (rr > 0) {
+    vgcanvas_arc_to(vg, x + w, y, x + w, y + rr, rr);
+  }
+  vgcanvas_line_to(vg, x + w, y + h - rr);
+  if (rr > 0) {
+    vgcanvas_arc_to(vg, x + w, y + h, x + w - rr, y + h, rr);
+  }
+  vgcanvas_line_to(vg, x + rl, y + h);
+  if (rl > 0) {
+    vgcanvas_arc_to(vg, x, y + h, x, y + h - rl, rl);
+  }
+  vgcanvas_line_to(vg, x, y + rl);
+  if (rl > 0) {
+    vgcanvas_arc_to(vg, x, y, x + rl, y, rl);
+  }
+
+  return vgcanvas_close_path(vg);
+}
+
+/*
+ * GPU后端上每次fill都是一次draw call，并伴随颜色状态切换：
+ * 背景一次填充，两段前景合并为一条路径一次填充，圆角直接作为路径的一部分。
+ */
+static ret_t range_slider_fill_track_vg(widget_t* widget, canvas_t* c, vgcanvas_t* vg,
+                                        rect_t* br, rect_t* fr1, rect_t* fr2) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  const range_slider_style_cache_t* cache = range_slider_get_style_cache(widget);
+  return_value_if_fail(range_slider != NULL && cache != NULL, RET_BAD_PARAMS);
+#if RANGE_SLIDER_WITH_ROUND
+  float_t radius = cache->round_radius > 3 ? cache->round_radius : 0;
+#else
+  float_t radius = 0;
+#endif /*RANGE_SLIDER_WITH_ROUND*/
+  bool_t has_fr1 = fr1->w > 0 && fr1->h > 0;
+  bool_t has_fr2 = !RANGE_SLIDER_SINGLE_THUMB(range_slider) && fr2->w > 0 && fr2->h > 0;
+
+  vgcanvas_save(vg);
+  vgcanvas_translate(vg, c->ox, c->oy);
+
+  if (cache->bg_color.rgba.a && br->w > 0 && br->h > 0) {
+    vgcanvas_begin_path(vg);
+    range_slider_vg_add_segment(vg, br, radius, TRUE, TRUE);
+    vgcanvas_set_fill_color(vg, cache->bg_color);
+    vgcanvas_fill(vg);
+    range_slider->track_draw_calls++;
+  }
+
+  if (cache->fg_color.rgba.a && (has_fr1 || has_fr2)) {
+    vgcanvas_begin_path(vg);
+    if (has_fr1) {
+      range_slider_vg_add_segment(vg, fr1, radius, TRUE, FALSE);
+    }
+    if (has_fr2) {
+      range_slider_vg_add_segment(vg, fr2, radius, FALSE, TRUE);
+    }
+    vgcanvas_set_fill_color(vg, cache->fg_color);
+    vgcanvas_fill(vg);
+    range_slider->track_draw_calls++;
+  }
+
+  vgcanvas_restore(vg);
+
+  return RET_OK;
+}
+#endif /*WITH_NANOVG_GPU*/
+
+/* 绘制背景和两段前景，track_draw_calls记录填充的次数 */
+static ret_t range_slider_fill_track(widget_t* widget, canvas_t* c, rect_t* br, rect_t* fr1,
+                                     rect_t* fr2) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL && c != NULL, RET_BAD_PARAMS);
+
+  range_slider->track_draw_calls = 0;
+#ifdef WITH_NANOVG_GPU
+  {
+    vgcanvas_t* vg = canvas_get_vgcanvas(c);
+    if (vg != NULL) {
+      return range_slider_fill_track_vg(widget, c, vg, br, fr1, fr2);
+    }
+  }
+#endif /*WITH_NANOVG_GPU*/
+
+  range_slider_fill_rect(widget, c, br, NULL, false);
+  range_slider_fill_rect(widget, c, fr1, br, true);
+  if (!RANGE_SLIDER_SINGLE_THUMB(range_slider)) {
+    range_slider_fill_rect(widget, c, fr2, br, true);
+  }
+
+  return RET_OK;
+}
+
+static ret_t range_slider_check_on_dragger_icon(widget_t* widget) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
+  const range_slider_style_cache_t* cache = range_slider_get_style_cache(widget);
+  return_value_if_fail(cache != NULL, RET_BAD_PARAMS);
+
+  range_slider->no_dragger_icon = cache->no_dragger_icon;
+  return RET_OK;
+}
+
+#if RANGE_SLIDER_WITH_LABELS
+/*
+ * 生成值label的文本："value1"或合并后的"value1 – value2"，数据个数附在最后。
+ * 返回文本是否完整放进了buf，被截断时不再继续拼接。
+ */
+static bool_t range_slider_build_value_text(range_slider_t* range_slider, char* buf,
+                                            uint32_t size, double value1, bool_t merged,
+                                            double value2, bool_t with_count, uint32_t count) {
+  uint32_t len = range_slider_format_value(range_slider, value1, buf, size);
+
+  if (merged && len < size) {
+    len += tk_snprintf(buf + len, size - len, " \xe2\x80\x93 ");
+  }
+  if (merged && len < size) {
+    len += range_slider_format_value(range_slider, value2, buf + len, size - len);
+  }
+  if (with_count && len < size) {
+    len += tk_snprintf(buf + len, size - len, " (%u)", count);
+  }
+
+  return len < size;
+}
+
+/* 设置值label的文本，栈上的缓冲区放不下时才从堆上分配 */
+static ret_t range_slider_set_value_text(range_slider_t* range_slider, widget_t* label,
+                                         double value1, bool_t merged, double value2,
+                                         bool_t with_count, uint32_t count) {
+  ret_t ret = RET_OK;
+  char* buf = NULL;
+  char text[RANGE_SLIDER_LABEL_UTF8_SIZE];
+
+  if (range_slider_build_value_text(range_slider, text, sizeof(text), value1, merged, value2,
+                                    with_count, count)) {
+    return range_slider_set_label_text(label, text);
+  }
+
+  buf = TKMEM_ALLOC(RANGE_SLIDER_LABEL_UTF8_MAX_SIZE);
+  return_value_if_fail(buf != NULL, RET_OOM);
+  range_slider_build_value_text(range_slider, buf, RANGE_SLIDER_LABEL_UTF8_MAX_SIZE, value1,
+                                merged, value2, with_count, count);
+  ret = widget_set_text_utf8(label, buf);
+  TKMEM_FREE(buf);
+
+  return ret;
+}
+
+/* 显示的内容与上次相同时跳过，拖动中只有变化的label需要转换文本和刷新 */
+static ret_t range_slider_update_value_label(range_slider_t* range_slider, widget_t* label,
+                                             uint32_t index, double value, bool_t with_count) {
+  range_slider_label_text_t* shown = range_slider->label_texts + index;
+  uint32_t count = with_count ? range_slider->count_in_range : 0;
+
+  if (shown->valid && !shown->merged && shown->value == value &&
+      shown->with_count == with_count && shown->count == count) {
+    return RET_OK;
+  }
+
+  shown->valid = TRUE;
+  shown->merged = FALSE;
+  shown->value = value;
+  shown->with_count = with_count;
+  shown->count = count;
+
+  return range_slider_set_value_text(range_slider, label, value, FALSE, 0, with_count, count);
+}
+
+/* 合并后的label显示"value1 – value2"，数据个数附在最后 */
+static ret_t range_slider_update_merged_label(range_slider_t* range_slider, widget_t* label,
+                                              bool_t with_count) {
+  range_slider_label_text_t* shown = range_slider->label_texts;
+  uint32_t count = with_count ? range_slider->count_in_range : 0;
+
+  if (shown->valid && shown->merged && shown->value == range_slider->value1 &&
+      shown->value2 == range_slider->value2 && shown->with_count == with_count &&
+      shown->count == count) {
+    return RET_OK;
+  }
+
+  shown->valid = TRUE;
+  shown->merged = TRUE;
+  shown->value = range_slider->value1;
+  shown->value2 = range_slider->value2;
+  shown->with_count = with_count;
+  shown->count = count;
+  /* 分开后第二个label需要重设文本 */
+  range_slider->label_texts[1].valid = FALSE;
+
+  return range_slider_set_value_text(range_slider, label, range_slider->value1, TRUE,
+                                     range_slider->value2, with_count, count);
+}
+
+/* 测量值label中可能出现的字符的宽度，样式改变后只测量一次，之后的绘制和拖动都使用缓存的结果 */
+static ret_t range_slider_measure_label_metrics(range_slider_t* range_slider, widget_t* label) {
+  wchar_t digit[2] = {0, 0};
+  range_slider_label_metrics_t* metrics = &(range_slider->label_metrics);
+
+  if (metrics->valid) {
+    return RET_OK;
+  }
+
+  metrics->digit = 0;
+  for (digit[0] = '0'; digit[0] <= '9'; digit[0]++) {
+    metrics->digit = tk_max(metrics->digit, widget_measure_text(label, digit));
+  }
+  metrics->minus = widget_measure_text(label, L"-");
+  metrics->space = widget_measure_text(label, L" ");
+  metrics->parens = widget_measure_text(label, L"()");
+  metrics->dash = widget_measure_text(label, L" \x2013 ");
+  metrics->width = 0;
+  /* 还不在窗口中(没有canvas)时测不出来，下次再测 */
+  metrics->valid = metrics->digit > 0;
+
+  return RET_OK;
+}
+
+static uint32_t range_slider_count_digits(double value) {
+  uint32_t n = 1;
+
+  for (value = round(fabs(value)); value >= 10; value /= 10) {
+    n++;
+  }
+
+  return n;
+}
+
+#define RANGE_SLIDER_DEFAULT_VALUE_LABEL_WIDTH 50
+/* 自动宽度时文本两侧留的空白 */
+#define RANGE_SLIDER_VALUE_LABEL_PADDING 4
+
+/* value_label_width为0时，按当前范围和格式下最宽的文本(每一位都取最宽的数字)计算，只在范围或格式改变时计算 */
+static uint32_t range_slider_get_value_label_width(range_slider_t* range_slider,
+                                                   bool_t with_count) {
+  float_t width = 0;
+  uint32_t total = 0;
+  const range_slider_dataset_t* ds = &(range_slider->dataset);
+  range_slider_label_metrics_t* metrics = &(range_slider->label_metrics);
+
+  if (range_slider->value_label_width > 0) {
+    return range_slider->value_label_width;
+  }
+  /* 索引模式下的文本由回调生成，无法预知最宽的文本 */
+  if (range_slider->index_label != NULL || !metrics->valid) {
+    return RANGE_SLIDER_DEFAULT_VALUE_LABEL_WIDTH;
+  }
+
+  if (with_count) {
+    total = ds->prefix_count != NULL ? (uint32_t)(ds->prefix_count[ds->nr]) : ds->nr;
+  }
+  if (metrics->width > 0 && metrics->min == range_slider->min &&
+      metrics->max == range_slider->max && metrics->with_count == with_count &&
+      metrics->total == total) {
+    return metrics->width;
+  }
+
+  width = tk_max(range_slider_count_digits(range_slider->min),
+                 range_slider_count_digits(range_slider->max)) *
+          metrics->digit;
+  if (range_slider->min < 0) {
+    width += metrics->minus;
+  }
+  if (with_count) {
+    width += metrics->space + metrics->parens + range_slider_count_digits(total) * metrics->digit;
+  }
+
+  metrics->width = (uint32_t)ceil(width) + RANGE_SLIDER_VALUE_LABEL_PADDING;
+  metrics->min = range_slider->min;
+  metrics->max = range_slider->max;
+  metrics->with_count = with_count;
+  metrics->total = total;
+
+  return metrics->width;
+}
+
+static ret_t range_slider_update_label(widget_t* widget, rect_t* fr1, rect_t* fr2) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(widget != NULL && range_slider != NULL, RET_BAD_PARAMS);
+  widget_t* label_min = range_slider->label_min;
+  widget_t* label_max = range_slider->label_max;
+  widget_t* label_value1 = range_slider->label_value1;
+  widget_t* label_value2 = range_slider->label_value2;
+  widget_t* range_slider_view = range_slider->view;
+  return_value_if_fail(range_slider_view != NULL, RET_BAD_PARAMS);
+
+  RANGE_SLIDER_TRACE_BEGIN(RANGE_SLIDER_TRACE_UPDATE_LABEL, 0);
+  /* 数据个数显示在右侧的值label上(单滑块时为value1的label) */
+  bool_t with_count =
+      range_slider->count_label_visible && !range_slider_dataset_is_empty(&range_slider->dataset);
+  uint32_t count_index = RANGE_SLIDER_SINGLE_THUMB(range_slider) ? 0 : 1;
+  /* 只有自动宽度需要测量字符宽度 */
+  widget_t* value_label = label_value1 != NULL ? label_value1 : label_value2;
+  if (value_label != NULL && range_slider->value_label_width == 0 &&
+      range_slider->index_label == NULL) {
+    range_slider_measure_label_metrics(range_slider, value_label);
+  }
+
+  uint32_t range_label_width = (widget->w - range_slider_view_get_width(widget)) / 2 - range_slider->range_label_gap * 2;
+  uint32_t range_label_height = range_slider_view_get_height(widget);
+  uint32_t value_label_width = range_slider_get_value_label_width(range_slider, with_count);
+  uint32_t value_label_gap = range_slider->value_label_gap;
+  uint32_t value_label_height = widget->h - range_slider_view->h - value_label_gap;
+  xy_t value_label_y = widget->h - value_label_height;
+  xy_t x1 = fr1->x + fr1->w - value_label_width / 2;
+  xy_t x2 = fr2->x - value_label_width / 2;
+
+  if (label_min != NULL && label_max != NULL) {
+    widget_move_resize(label_min, 0, 0, range_label_width, range_label_height);
+    widget_move_resize(label_max, widget->w - range_label_width, 0, range_label_width,
+                       range_label_height);
+  }
+
+  if (label_value1 != NULL && label_value2 != NULL && label_value2->visible &&
+      x1 + (xy_t)value_label_width > x2) {
+    /* 两个label重叠时合并到第一个，居中于两个滑块之间，第二个宽度置0 */
+    wh_t merged_w = value_label_width * 2;
+    if (range_slider->label_metrics.valid) {
+      merged_w += (wh_t)ceil(range_slider->label_metrics.dash);
+    }
+    xy_t center = (fr1->x + fr1->w + fr2->x) / 2;
+    xy_t x = tk_max(0, tk_min(center - merged_w / 2, widget->w - merged_w));
+
+    range_slider_update_merged_label(range_slider, label_value1, with_count);
+    widget_move_resize(label_value1, x, value_label_y, merged_w, value_label_height);
+    widget_move_resize(label_value2, x2, value_label_y, 0, value_label_height);
+  } else {
+    if (label_value1 != NULL) {
+      range_slider_update_value_label(range_slider, label_value1, 0, range_slider->value1,
+                                      with_count && count_index == 0);
+      widget_move_resize(label_value1, x1, value_label_y, value_label_width, value_label_height);
+    }
+    if (label_value2 != NULL) {
+      range_slider_update_value_label(range_slider, label_value2, 1, range_slider->value2,
+                                      with_count && count_index == 1);
+      widget_move_resize(label_value2, x2, value_label_y, value_label_width, value_label_height);
+    }
+  }
+  RANGE_SLIDER_TRACE_END(RANGE_SLIDER_TRACE_UPDATE_LABEL, 0);
+
+  return RET_OK;
+}
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+
+/* 缩放时在view底部绘制概览条：背景为整个[min, max]，前景为当前显示的区间 */
+static ret_t range_slider_paint_overview(widget_t* widget, canvas_t* c) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL && range_slider->view != NULL, RET_BAD_PARAMS);
+  widget_t* range_slider_view = range_slider->view;
+  double range = range_slider->max - range_slider->min;
+  rect_t strip;
+  rect_t box;
+
+  if (range_slider->view_span <= 0 || range_slider->overview_height == 0 || range <= 0) {
+    return RET_OK;
+  }
+
+  strip.h = tk_min(range_slider->overview_height, range_slider_view->h);
+  strip.x = range_slider_view_get_x(widget);
+  strip.y = range_slider_view->y + range_slider_view->h - strip.h;
+  strip.w = range_slider_view->w;
+
+  box = strip;
+  box.x += (range_slider->view_start - range_slider->min) / range * strip.w;
+  box.w = tk_max(range_slider->view_span / range * strip.w, 1);
+
+  range_slider_fill_rect(widget, c, &strip, NULL, false);
+  range_slider_fill_rect(widget, c, &box, NULL, true);
+
+  return RET_OK;
+}
+
+/* 控件内的区域是否与当前的裁剪区(脏矩形)相交 */
+static bool_t range_slider_area_visible(canvas_t* c, const rect_t* clip, const rect_t* area) {
+  rect_t r = rect_init(c->ox + area->x, c->oy + area->y, area->w, area->h);
+
+  return area->w > 0 && area->h > 0 && rect_has_intersection(clip, &r);
+}
+
+/*
+ * 只处理与裁剪区相交的部分：脏矩形与控件不相交时(如滚动视图中移出可视区的控件)直接返回；
+ * 只有相邻控件的刷新波及到label所在的区域时，不重绘滑轨。
+ * 滑块的位置每次都更新(只是几次赋值)，滑块本身作为子控件由框架按裁剪区绘制。
+ */
+static ret_t range_slider_on_paint_self(widget_t* widget, canvas_t* c) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL && c != NULL, RET_BAD_PARAMS);
+  rect_t br, fr1, fr2;
+  rect_t clip, area;
+
+  canvas_get_clip_rect(c, &clip);
+  area = rect_init(0, 0, widget->w, widget->h);
+  if (!range_slider_area_visible(c, &clip, &area)) {
+    return RET_OK;
+  }
+
+  range_slider_flush_config(widget);
+  range_slider_ensure_children(widget);
+  widget_t* dragger1 = range_slider->dragger1;
+  widget_t* dragger2 = RANGE_SLIDER_DRAGGER2(range_slider);
+  return_value_if_fail(dragger1 != NULL, RET_BAD_PARAMS);
+  widget_t* range_slider_view = range_slider->view;
+  return_value_if_fail(range_slider_view != NULL, RET_BAD_PARAMS);
+
+  RANGE_SLIDER_TRACE_BEGIN(RANGE_SLIDER_TRACE_PAINT, 0);
+  range_slider_check_on_dragger_icon(widget);
+  range_slider_update_dragger_rect(widget, dragger1);
+  if (dragger2 != NULL) {
+    range_slider_update_dragger_rect(widget, dragger2);
+  }
+
+  if (range_slider_get_bar_rect(widget, &br, &fr1, &fr2) != RET_OK) {
+    /* 提前返回也要结束跟踪区间，否则begin没有配对的end */
+    RANGE_SLIDER_TRACE_END(RANGE_SLIDER_TRACE_PAINT, 0);
+    return RET_BAD_PARAMS;
+  }
+  area = range_slider_track_area(widget);
+  if (range_slider_area_visible(c, &clip, &area)) {
+    range_slider_fill_track(widget, c, &br, &fr1, &fr2);
+    range_slider_paint_overview(widget, c);
+  } else {
+    range_slider->track_draw_calls = 0;
+  }
+
+#if RANGE_SLIDER_WITH_LABELS
+  area = range_slider_value_label_area(widget);
+  if (range_slider_area_visible(c, &clip, &area)) {
+    range_slider_update_label(widget, &fr1, &fr2);
+  }
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+  RANGE_SLIDER_TRACE_END(RANGE_SLIDER_TRACE_PAINT, 0);
+  return RET_OK;
+}
+
+/* 全局坐标转换为值(已钳位到[min, max]) */
+static double range_slider_point_to_value(widget_t* widget, xy_t x, xy_t y) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL && range_slider->view != NULL, 0);
+  widget_t* range_slider_view = range_slider->view;
+
+  const range_slider_style_cache_t* cache = range_slider_get_style_cache(widget);
+  return_value_if_fail(cache != NULL, range_slider->min);
+
+  double value = 0;
+  point_t p = {x, y};
+  widget_to_local(range_slider_view, &p);
+  double start = 0;
+  double range = range_slider_visible_range(range_slider, &start);
+  uint32_t dragger_size = range_slider_get_dragger_size(widget);
+  int32_t margin = range_slider->no_dragger_icon ? 0 : cache->margin;
+  if (range_slider->no_dragger_icon) {
+    value = range * p.x / range_slider_view_get_width(widget);
+  } else {
+    int32_t half_dragger_size = dragger_size >> 1;
+    //align mouse to the middle of the dragger
+    value =
+        tk_clamp(range * (p.x - half_dragger_size - margin) /
+                     (int32_t)(range_slider_view_get_width(widget) - dragger_size - (margin << 1)),
+                 0.0, range);
+  }
+  value += start;
+
+  return tk_clamp(value, start, start + range);
+}
+
+static ret_t range_slider_change_value_by_pointer_event(widget_t* widget, pointer_event_t* evt,
+                                                        dragger_index dr_idx) {
+  return_value_if_fail(widget != NULL && evt != NULL, RET_BAD_PARAMS);
+  double value = range_slider_point_to_value(widget, evt->x, evt->y);
+  event_type_t evt_value_changing =
+      (dr_idx == kDragger1) ? EVT_VALUE1_CHANGING : EVT_VALUE2_CHANGING;
+  return range_slider_set_value_internal(widget, value, evt_value_changing, dr_idx);
+}
+
+static bool_t range_slider_has_touch(range_slider_t* range_slider) {
+  uint32_t i = 0;
+
+  for (i = 0; i < ARRAY_SIZE(range_slider->touches); i++) {
+    if (range_slider->touches[i].active) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/* 触摸事件的坐标是相对屏幕的比例(0-1)，转换为全局坐标 */
+static point_t range_slider_touch_point(touch_event_t* evt) {
+  point_t p;
+  system_info_t* info = system_info();
+
+  p.x = (xy_t)(evt->x * info->lcd_w);
+  p.y = (xy_t)(evt->y * info->lcd_h);
+
+  return p;
+}
+
+/*
+ * 把本帧内各个手指最新的位置合并为一次更新：两个值一起钳位和防碰撞，
+ * 只更新一次统计、只分发一次EVT_RANGE_CHANGED、只刷新一次。
+ */
+static ret_t range_slider_flush_touches(widget_t* widget) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
+#if RANGE_SLIDER_WITH_SECOND_THUMB
+  range_slider_touch_t* t2 = range_slider->touches + kDragger2;
+#else
+  range_slider_touch_t no_touch = {0};
+  range_slider_touch_t* t2 = &no_touch;
+#endif /*RANGE_SLIDER_WITH_SECOND_THUMB*/
+  range_slider_touch_t* t1 = range_slider->touches + kDragger1;
+  double old_value1 = range_slider->value1;
+  double old_value2 = range_slider->value2;
+  uint32_t* hint1 = range_slider->allowed_hint + kDragger1;
+  uint32_t* hint2 = range_slider->allowed_hint + 1;
+  double value1 = t1->pending ? range_slider_snap_value(range_slider, t1->pending_value, hint1)
+                              : old_value1;
+  double value2 = t2->pending ? range_slider_snap_value(range_slider, t2->pending_value, hint2)
+                              : old_value2;
+  bool_t changed1 = FALSE;
+  bool_t changed2 = FALSE;
+
+  if (range_slider->touch_idle_id != TK_INVALID_ID) {
+    idle_remove(range_slider->touch_idle_id);
+    range_slider->touch_idle_id = TK_INVALID_ID;
+  }
+
+  if (!RANGE_SLIDER_SINGLE_THUMB(range_slider) && value1 >= value2) {
+    /* 手指交叉时，移动的一方停在另一方旁边 */
+    if (t2->pending && !t1->pending) {
+      value2 = range_slider_adjacent_value(range_slider, value1, 1, hint2);
+    } else {
+      value1 = range_slider_adjacent_value(range_slider, value2, -1, hint1);
+    }
+  }
+  t1->pending = FALSE;
+  t2->pending = FALSE;
+
+  changed1 = value1 != old_value1;
+  changed2 = value2 != old_value2 && !RANGE_SLIDER_SINGLE_THUMB(range_slider);
+  if (!changed1 && !changed2) {
+    return RET_OK;
+  }
+
+  range_slider->value1 = value1;
+  if (changed2) {
+    range_slider->value2 = value2;
+  }
+  range_slider_update_stats(widget);
+
+  if (changed1) {
+    value_change_event_t evt;
+    value_change_event_init(&evt, EVT_VALUE1_CHANGING, widget);
+    value_set_double(&(evt.old_value), old_value1);
+    value_set_double(&(evt.new_value), value1);
+    widget_dispatch(widget, (event_t*)&evt);
+  }
+  if (changed2) {
+    value_change_event_t evt;
+    value_change_event_init(&evt, EVT_VALUE2_CHANGING, widget);
+    value_set_double(&(evt.old_value), old_value2);
+    value_set_double(&(evt.new_value), value2);
+    widget_dispatch(widget, (event_t*)&evt);
+  }
+
+  if (changed1 && changed2) {
+    range_slider_dispatch_range_event(widget, RANGE_SLIDER_DRAGGER_BOTH,
+                                      RANGE_SLIDER_PHASE_CHANGING, 0, 0);
+  } else if (changed1) {
+    range_slider_dispatch_range_event(widget, kDragger1, RANGE_SLIDER_PHASE_CHANGING, old_value1,
+                                      value1);
+  } else {
+    range_slider_dispatch_range_event(widget, kDragger2, RANGE_SLIDER_PHASE_CHANGING, old_value2,
+                                      value2);
+  }
+
+  return range_slider_invalidate(widget);
+}
+
+static ret_t range_slider_on_touch_idle(const idle_info_t* info) {
+  widget_t* widget = WIDGET(info->ctx);
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL, RET_REMOVE);
+
+  range_slider->touch_idle_id = TK_INVALID_ID;
+  range_slider_flush_touches(widget);
+
+  return RET_REMOVE;
+}
+
+/* 按下的位置在滑块上时拖动该滑块，否则拖动离得最近的空闲滑块 */
+static int32_t range_slider_touch_hit(widget_t* widget, point_t p) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  int32_t nearest = -1;
+  int32_t nearest_dist = 0;
+  uint32_t i = 0;
+
+  widget_to_local(range_slider->view, &p);
+  if (p.x < 0 || p.y < 0 || p.x >= range_slider->view->w || p.y >= range_slider->view->h) {
+    return -1;
+  }
+
+  for (i = 0; i < ARRAY_SIZE(range_slider->touches); i++) {
+    widget_t* dragger = i == kDragger1 ? range_slider->dragger1 : RANGE_SLIDER_DRAGGER2(range_slider);
+    if (dragger == NULL || range_slider->touches[i].active) {
+      continue;
+    }
+    if (rect_contains((rect_t*)dragger, p.x, p.y)) {
+      return i;
+    } else {
+      int32_t dist = tk_abs(p.x - (dragger->x + dragger->w / 2));
+      if (nearest < 0 || dist < nearest_dist) {
+        nearest = i;
+        nearest_dist = dist;
+      }
+    }
+  }
+
+  return nearest;
+}
+
+/* 每个手指独立拖动一个滑块 */
+static ret_t range_slider_on_touch_event(widget_t* widget, touch_event_t* evt) {
+  uint32_t i = 0;
+  ret_t ret = RET_OK;
+  point_t p = range_slider_touch_point(evt);
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL && range_slider->view != NULL, RET_BAD_PARAMS);
+  range_slider_touch_t* touch = NULL;
+
+  for (i = 0; i < ARRAY_SIZE(range_slider->touches); i++) {
+    if (range_slider->touches[i].active &&
+        range_slider->touches[i].finger_id == evt->finger_id) {
+      touch = range_slider->touches + i;
+      break;
+    }
+  }
+
+  switch (evt->e.type) {
+    case EVT_TOUCH_DOWN: {
+      int32_t idx = 0;
+      if (touch != NULL || !widget->enable) {
+        break;
+      }
+      idx = range_slider_touch_hit(widget, p);
+      if (idx < 0) {
+        break;
+      }
+      if (range_slider->input_state == RANGE_SLIDER_INPUT_DRAGGING) {
+        /* 第一个手指同时会产生指针事件，由触摸接管 */
+        widget_ungrab(range_slider->view, range_slider->active_dragger == kDragger1
+                                              ? range_slider->dragger1
+                                              : RANGE_SLIDER_DRAGGER2(range_slider));
+        range_slider->input_state = RANGE_SLIDER_INPUT_IDLE;
+      }
+      touch = range_slider->touches + idx;
+      touch->active = TRUE;
+      touch->pending = FALSE;
+      touch->finger_id = evt->finger_id;
+      touch->start_value = idx == kDragger1 ? range_slider->value1 : range_slider->value2;
+      range_slider_dispatch_value_change_event(
+          widget, idx == kDragger1 ? EVT_VALUE1_WILL_CHANGE : EVT_VALUE2_WILL_CHANGE,
+          (dragger_index)idx, touch->start_value, touch->start_value);
+      ret = RET_STOP;
+      break;
+    }
+    case EVT_TOUCH_MOVE: {
+      if (touch == NULL) {
+        break;
+      }
+      touch->pending_value = range_slider_point_to_value(widget, p.x, p.y);
+      touch->pending = TRUE;
+      if (range_slider->touch_idle_id == TK_INVALID_ID) {
+        range_slider->touch_idle_id = idle_add(range_slider_on_touch_idle, widget);
+      }
+      ret = RET_STOP;
+      break;
+    }
+    case EVT_TOUCH_UP: {
+      dragger_index dr_idx = kDragger1;
+      if (touch == NULL) {
+        break;
+      }
+      dr_idx = (dragger_index)(touch - range_slider->touches);
+      touch->pending_value = range_slider_point_to_value(widget, p.x, p.y);
+      touch->pending = TRUE;
+      range_slider_flush_touches(widget);
+      touch->active = FALSE;
+      range_slider_dispatch_value_change_event(
+          widget, dr_idx == kDragger1 ? EVT_VALUE1_CHANGED : EVT_VALUE2_CHANGED, dr_idx,
+          touch->start_value, dr_idx == kDragger1 ? range_slider->value1 : range_slider->value2);
+      ret = RET_STOP;
+      break;
+    }
+    default:
+      break;
+  }
+
+  return ret;
+}
+
+/*
+ * 触摸事件由窗口管理器分发。全部range_slider共用一个EVT_TOUCH_DOWN监听，
+ * 手指按在某个控件的滑块上后，该控件才监听EVT_TOUCH_MOVE/EVT_TOUCH_UP，最后一个手指抬起后移除。
+ */
+/* 从当前顶层窗口逐层查找触点下的range_slider */
+static widget_t* range_slider_find_touch_target(point_t p) {
+  widget_t* iter = window_manager_get_top_window(window_manager());
+
+  while (iter != NULL && !WIDGET_IS_INSTANCE_OF(iter, range_slider)) {
+    iter = widget_find_target(iter, p.x, p.y);
+  }
+
+  return iter;
+}
+
+static ret_t range_slider_on_wm_touch(void* ctx, event_t* e) {
+  widget_t* widget = WIDGET(ctx);
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL, RET_REMOVE);
+
+  range_slider_on_touch_event(widget, (touch_event_t*)e);
+  if (!range_slider_has_touch(range_slider)) {
+    widget_off_by_ctx(window_manager(), widget);
+  }
+
+  return RET_OK;
+}
+
+static ret_t range_slider_on_wm_touch_down(void* ctx, event_t* e) {
+  bool_t touching = FALSE;
+  touch_event_t* evt = (touch_event_t*)e;
+  widget_t* widget = range_slider_find_touch_target(range_slider_touch_point(evt));
+  (void)ctx;
+
+  if (widget == NULL) {
+    return RET_OK;
+  }
+
+  touching = range_slider_has_touch(RANGE_SLIDER(widget));
+  if (range_slider_on_touch_event(widget, evt) == RET_STOP && !touching) {
+    widget_on(window_manager(), EVT_TOUCH_MOVE, range_slider_on_wm_touch, widget);
+    widget_on(window_manager(), EVT_TOUCH_UP, range_slider_on_wm_touch, widget);
+  }
+
+  return RET_OK;
+}
+
+static ret_t range_slider_on_event(widget_t* widget, event_t* e) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
+  widget_t* dragger1 = range_slider->dragger1;
+  widget_t* dragger2 = RANGE_SLIDER_DRAGGER2(range_slider);
+  widget_t* range_slider_view = range_slider->view;
+  if (!(dragger1 != NULL && range_slider_view != NULL)) {
+    /* 子控件还未初始化完毕，先返回 */
+    return RET_BAD_PARAMS;
+  }
+
+  pointer_event_t* evt = (pointer_event_t*)e;
+  point_t p = {evt->x, evt->y};
+  ret_t ret = RET_OK;
+
+  if (range_slider_has_touch(range_slider) &&
+      (e->type == EVT_POINTER_DOWN || e->type == EVT_POINTER_MOVE || e->type == EVT_POINTER_UP)) {
+    /* 手指拖动中，忽略由触摸模拟出来的指针事件 */
+    return RET_OK;
+  }
+
+  RANGE_SLIDER_TRACE_BEGIN(RANGE_SLIDER_TRACE_EVENT, e->type);
+  switch (e->type) {
+    case EVT_POINTER_DOWN: {
+      rect_t* dr1 = (rect_t*)dragger1;
+      rect_t* dr2 = (rect_t*)dragger2;
+      widget_to_local(range_slider_view, &p);
+      if (rect_contains(dr1, p.x, p.y)) {
+        range_slider->drag_start_value = range_slider->value1;
+        range_slider_dispatch_value_change_event(widget, EVT_VALUE1_WILL_CHANGE, kDragger1,
+                                                 range_slider->value1, range_slider->value1);
+        range_slider->input_state = RANGE_SLIDER_INPUT_DRAGGING;
+        range_slider->active_dragger = kDragger1;
+        widget_grab(range_slider_view, dragger1);
+      } else if (dr2 != NULL && rect_contains(dr2, p.x, p.y)) {
+        range_slider->drag_start_value = range_slider->value2;
+        range_slider_dispatch_value_change_event(widget, EVT_VALUE2_WILL_CHANGE, kDragger2,
+                                                 range_slider->value2, range_slider->value2);
+        range_slider->input_state = RANGE_SLIDER_INPUT_DRAGGING;
+        range_slider->active_dragger = kDragger2;
+        widget_grab(range_slider_view, dragger2);
+      }
+      break;
+    }
+    case EVT_POINTER_MOVE: {
+      if (range_slider->input_state == RANGE_SLIDER_INPUT_DRAGGING) {
+        range_slider_change_value_by_pointer_event(widget, evt,
+                                                   (dragger_index)range_slider->active_dragger);
+      }
+      break;
+    }
+    case EVT_POINTER_UP: {
+      if (range_slider->input_state == RANGE_SLIDER_INPUT_DRAGGING) {
+        dragger_index dr_idx = (dragger_index)range_slider->active_dragger;
+        widget_t* dragger = (dr_idx == kDragger1) ? dragger1 : dragger2;
+        range_slider->input_state = RANGE_SLIDER_INPUT_IDLE;
+        range_slider_change_value_by_pointer_event(widget, evt, dr_idx);
+        range_slider_dispatch_value_change_event(
+            widget, (dr_idx == kDragger1) ? EVT_VALUE1_CHANGED : EVT_VALUE2_CHANGED, dr_idx,
+            range_slider->drag_start_value,
+            (dr_idx == kDragger1) ? range_slider->value1 : range_slider->value2);
+        widget_ungrab(range_slider_view, dragger);
+#if RANGE_SLIDER_WITH_KEYBOARD
+        range_slider_sync_input_state(range_slider, dragger, dr_idx);
+#endif /*RANGE_SLIDER_WITH_KEYBOARD*/
+      }
+      break;
+    }
+#if RANGE_SLIDER_WITH_KEYBOARD
+    case EVT_POINTER_LEAVE:
+      if (range_slider->input_state == RANGE_SLIDER_INPUT_GRABBED) {
+        range_slider_release_dragger(range_slider->active_dragger == kDragger1 ? dragger1
+                                                                                : dragger2);
+      }
+      break;
+#endif /*RANGE_SLIDER_WITH_KEYBOARD*/
+    case EVT_TOUCH_DOWN:
+    case EVT_TOUCH_MOVE:
+    case EVT_TOUCH_UP: {
+      ret = range_slider_on_touch_event(widget, (touch_event_t*)e);
+      break;
+    }
+    case EVT_WHEEL: {
+      /* ctrl+滚轮缩放，缩放后shift+滚轮平移，其它滚轮事件留给外层(如滚动视图) */
+      wheel_event_t* wevt = (wheel_event_t*)e;
+      if (wevt->dy != 0 && wevt->ctrl) {
+        range_slider_zoom_by_step(widget, wevt->dy > 0);
+        ret = RET_STOP;
+      } else if (wevt->dy != 0 && wevt->shift && range_slider->view_span > 0) {
+        range_slider_pan(widget, wevt->dy > 0 ? -RANGE_SLIDER_PAN_STEP : RANGE_SLIDER_PAN_STEP);
+        ret = RET_STOP;
+      }
+      break;
+    }
+    case EVT_WIDGET_LOAD: {
+      range_slider_flush_config(widget);
+      break;
+    }
+    case EVT_THEME_CHANGED: {
+      range_slider_invalidate_style_cache(widget);
+      break;
+    }
+    case EVT_PROP_CHANGED: {
+      prop_change_event_t* evt = (prop_change_event_t*)e;
+      if (tk_str_eq(evt->name, WIDGET_PROP_STYLE)) {
+        range_slider_invalidate_style_cache(widget);
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  RANGE_SLIDER_TRACE_END(RANGE_SLIDER_TRACE_EVENT, e->type);
+  return ret;
+}
+
+static ret_t range_slider_on_layout_children(widget_t* widget) {
   range_slider_t* range_slider = RANGE_SLIDER(widget);
   return_value_if_fail(widget != NULL && range_slider != NULL, RET_BAD_PARAMS);
-  widget_t* label_min = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_LABEL_MIN, TRUE);
-  widget_t* label_max = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_LABEL_MAX, TRUE);
-  widget_t* label_value1 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_LABEL_VALUE1, TRUE);
-  widget_t* label_value2 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_LABEL_VALUE2, TRUE);
-  return_value_if_fail(
-      label_min != NULL && label_max != NULL && label_value1 != NULL && label_value2 != NULL,
-      RET_BAD_PARAMS);
-  widget_t* range_slider_view = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_VIEW, TRUE);
+  range_slider_flush_config(widget);
+  range_slider_ensure_children(widget);
+  widget_t* range_slider_view = range_slider->view;
   return_value_if_fail(range_slider_view != NULL, RET_BAD_PARAMS);
 
-  char textbuf[10] = {0};
-  sprintf(textbuf, "%.f", range_slider->value1);
-  widget_set_text_utf8(label_value1, textbuf);
-  memset(textbuf, 0, sizeof(textbuf));
+  RANGE_SLIDER_TRACE_BEGIN(RANGE_SLIDER_TRACE_LAYOUT, 0);
+  range_slider_layout_t layout;
+  memset(&layout, 0x00, sizeof(layout));
+  layout.valid = TRUE;
+  layout.w = widget->w;
+  layout.h = widget->h;
+  layout.width_ratio = range_slider->range_slider_view_width_ratio;
+  layout.height_ratio = range_slider->range_slider_view_height_ratio;
+  layout.min = range_slider->min;
+  layout.max = range_slider->max;
+#if RANGE_SLIDER_WITH_LABELS
+  layout.range_label_gap = range_slider->range_label_gap;
+  layout.value_min_show_one_point = range_slider->value_min_show_one_point;
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+  if (memcmp(&layout, &(range_slider->layout), sizeof(layout)) == 0) {
+    /* 输入未变化，布局结果仍然有效 */
+    RANGE_SLIDER_TRACE_END(RANGE_SLIDER_TRACE_LAYOUT, 0);
+    return RET_OK;
+  }
+
+  widget_move_resize(range_slider_view, widget->w / 2 - range_slider_view_get_width(widget) / 2, 0,
+                     range_slider_view_get_width(widget), range_slider_view_get_height(widget));
+
+#if RANGE_SLIDER_WITH_LABELS
+  widget_t* label_min = range_slider->label_min;
+  widget_t* label_max = range_slider->label_max;
+  uint32_t range_label_width =
+      (widget->w - range_slider_view_get_width(widget)) / 2 - range_slider->range_label_gap * 2;
+  uint32_t range_label_height = range_slider_view_get_height(widget);
+
+  if (label_min != NULL && label_max != NULL) {
+    range_slider_update_range_labels(widget, TRUE);
+    widget_move_resize(label_min, 0, 0, range_label_width, range_label_height);
+    widget_move_resize(label_max, widget->w - range_label_width, 0, range_label_width,
+                       range_label_height);
+  }
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+  memcpy(&(range_slider->layout), &layout, sizeof(layout));
+  RANGE_SLIDER_TRACE_END(RANGE_SLIDER_TRACE_LAYOUT, 0);
+
+  return RET_OK;
+}
+
+ret_t range_slider_get_config(widget_t* widget, range_slider_config_t* config) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL && config != NULL, RET_BAD_PARAMS);
+
+  memset(config, 0x00, sizeof(*config));
+  config->value1 = range_slider->value1;
+  config->value2 = range_slider->value2;
+  config->min = range_slider->min;
+  config->max = range_slider->max;
+  config->step = range_slider->step;
+  config->bar_size = range_slider->bar_size;
+  config->dragger_size = range_slider->dragger_size;
+  config->dragger_style = range_slider->dragger_style;
+  config->range_slider_view_width_ratio = range_slider->range_slider_view_width_ratio;
+  config->range_slider_view_height_ratio = range_slider->range_slider_view_height_ratio;
+#if RANGE_SLIDER_WITH_ADAPT_TO_ICON
+  config->dragger_adapt_to_icon = range_slider->dragger_adapt_to_icon;
+#endif /*RANGE_SLIDER_WITH_ADAPT_TO_ICON*/
+#if RANGE_SLIDER_WITH_SECOND_THUMB
+  config->no_use_second_dragger = range_slider->no_use_second_dragger;
+#else
+  config->no_use_second_dragger = TRUE;
+#endif /*RANGE_SLIDER_WITH_SECOND_THUMB*/
+#if RANGE_SLIDER_WITH_LABELS
+  config->range_label_style = range_slider->range_label_style;
+  config->value_label_style = range_slider->value_label_style;
+  config->range_label_visible = range_slider->range_label_visible;
+  config->value_label_visible = range_slider->value_label_visible;
+  config->range_label_gap = range_slider->range_label_gap;
+  config->value_label_gap = range_slider->value_label_gap;
+  config->value_label_width = range_slider->value_label_width;
+  config->value_min_show_one_point = range_slider->value_min_show_one_point;
+  config->count_label_visible = range_slider->count_label_visible;
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+#if RANGE_SLIDER_WITH_KEYBOARD
+  config->range_slider_focusable = range_slider->range_slider_focusable;
+#endif /*RANGE_SLIDER_WITH_KEYBOARD*/
+  config->follow = range_slider->follow;
+  config->overview_height = range_slider->overview_height;
+
+  return RET_OK;
+}
+
+/*
+ * 按属性名修改配置，样式名只是引用，不做拷贝。
+ * 被裁剪掉的功能的属性也在这里接受(随后被忽略)，避免加载时落入widget的自定义属性而占用内存。
+ */
+static ret_t range_slider_config_set_prop(range_slider_config_t* config, const char* name,
+                                          const value_t* v) {
+  if (tk_str_eq(name, WIDGET_PROP_MIN)) {
+    config->min = value_double(v);
+  } else if (tk_str_eq(name, WIDGET_PROP_MAX)) {
+    config->max = value_double(v);
+  } else if (tk_str_eq(name, WIDGET_PROP_STEP)) {
+    config->step = value_double(v);
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_VALUE1)) {
+    config->value1 = value_double(v);
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_VALUE2)) {
+    config->value2 = value_double(v);
+  } else if (tk_str_eq(name, WIDGET_PROP_BAR_SIZE)) {
+    config->bar_size = value_uint32(v);
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_DRAGGER_SIZE)) {
+    config->dragger_size = value_uint32(v);
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_DRAGGER_ADAPT_TO_ICON)) {
+    config->dragger_adapt_to_icon = value_bool(v);
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_DRAGGER_STYLE)) {
+    config->dragger_style = value_str(v);
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_NO_USE_SECOND_DRAGGER)) {
+    config->no_use_second_dragger = value_bool(v);
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_RANGE_LABEL_VISIBLE)) {
+    config->range_label_visible = value_bool(v);
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_VALUE_LABEL_VISIBLE)) {
+    config->value_label_visible = value_bool(v);
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_RANGE_LABEL_STYLE)) {
+    config->range_label_style = value_str(v);
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_VALUE_LABEL_STYLE)) {
+    config->value_label_style = value_str(v);
+  } else if (tk_str_eq(name, RANGE_SLIDER_SUB_WIDGET_RANGE_LABEL_GAP)) {
+    config->range_label_gap = value_uint32(v);
+  } else if (tk_str_eq(name, RANGE_SLIDER_SUB_WIDGET_VALUE_LABEL_GAP)) {
+    config->value_label_gap = value_uint32(v);
+  } else if (tk_str_eq(name, RANGE_SLIDER_SUB_WIDGET_VALUE_LABEL_WIDTH)) {
+    config->value_label_width = value_uint32(v);
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_FOCUSABLE)) {
+    config->range_slider_focusable = value_bool(v);
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_VIEW_WIDTH_RATIO)) {
+    config->range_slider_view_width_ratio = value_double(v);
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_VIEW_HEIGHT_RATIO)) {
+    config->range_slider_view_height_ratio = value_double(v);
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_VALUE_MIN_SHOW_ONE_POINT)) {
+    config->value_min_show_one_point = value_bool(v);
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_COUNT_LABEL_VISIBLE)) {
+    config->count_label_visible = value_bool(v);
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_FOLLOW)) {
+    config->follow = value_bool(v);
+  } else if (tk_str_eq(name, RANGE_SLIDER_PROP_OVERVIEW_HEIGHT)) {
+    config->overview_height = value_uint32(v);
+  } else {
+    return RET_NOT_FOUND;
+  }
 
-  sprintf(textbuf, "%.f", range_slider->value2);
-  widget_set_text_utf8(label_value2, textbuf);
-  memset(textbuf, 0, sizeof(textbuf));
+  return RET_OK;
+}
 
-  uint32_t range_label_width = (widget->w - range_slider_view_get_width(widget)) / 2 - range_slider->range_label_gap * 2;
-  uint32_t range_label_height = range_slider_view_get_height(widget);
-  uint32_t value_label_width = range_slider->value_label_width;
-  uint32_t value_label_gap = range_slider->value_label_gap;
-  uint32_t value_label_height = widget->h - range_slider_view->h - value_label_gap;
+/* 只保存配置(拷贝样式名)，不钳位，不更新子控件 */
+static ret_t range_slider_store_config(widget_t* widget, const range_slider_config_t* config) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL && config != NULL, RET_BAD_PARAMS);
+
+  range_slider->min = config->min;
+  range_slider->max = config->max;
+  range_slider->step = config->step;
+  range_slider->value1 = config->value1;
+  range_slider->value2 = config->value2;
+  range_slider->bar_size = config->bar_size;
+  range_slider->dragger_size = config->dragger_size;
+  range_slider->auto_get_dragger_size = config->dragger_size == 0;
+  range_slider->range_slider_view_width_ratio = config->range_slider_view_width_ratio;
+  range_slider->range_slider_view_height_ratio = config->range_slider_view_height_ratio;
+  range_slider->follow = config->follow;
+  range_slider->overview_height = config->overview_height;
+#if RANGE_SLIDER_WITH_ADAPT_TO_ICON
+  range_slider->dragger_adapt_to_icon = config->dragger_adapt_to_icon;
+#endif /*RANGE_SLIDER_WITH_ADAPT_TO_ICON*/
+#if RANGE_SLIDER_WITH_SECOND_THUMB
+  range_slider->no_use_second_dragger = config->no_use_second_dragger;
+#endif /*RANGE_SLIDER_WITH_SECOND_THUMB*/
+#if RANGE_SLIDER_WITH_KEYBOARD
+  range_slider->range_slider_focusable = config->range_slider_focusable;
+#endif /*RANGE_SLIDER_WITH_KEYBOARD*/
+
+  if (config->dragger_style != NULL && config->dragger_style != range_slider->dragger_style) {
+    range_slider->dragger_style = tk_str_copy(range_slider->dragger_style, config->dragger_style);
+  }
 
-  widget_move_resize(label_min, 0, 0, range_label_width, range_label_height);
-  widget_move_resize(label_max, widget->w - range_label_width, 0, range_label_width,
-                     range_label_height);
-  widget_move_resize(label_value1, fr1->x + fr1->w - value_label_width / 2,
-                     widget->h - value_label_height, value_label_width, value_label_height);
-  widget_move_resize(label_value2, fr2->x - value_label_width / 2, widget->h - value_label_height,
-                     value_label_width, value_label_height);
+#if RANGE_SLIDER_WITH_LABELS
+  range_slider->range_label_visible = config->range_label_visible;
+  range_slider->value_label_visible = config->value_label_visible;
+  range_slider->range_label_gap = config->range_label_gap;
+  range_slider->value_label_gap = config->value_label_gap;
+  range_slider->value_label_width = config->value_label_width;
+  range_slider->value_min_show_one_point = config->value_min_show_one_point;
+  range_slider->count_label_visible = config->count_label_visible;
+  if (config->range_label_style != NULL &&
+      config->range_label_style != range_slider->range_label_style) {
+    range_slider->range_label_style =
+        tk_str_copy(range_slider->range_label_style, config->range_label_style);
+  }
+  if (config->value_label_style != NULL &&
+      config->value_label_style != range_slider->value_label_style) {
+    range_slider->value_label_style =
+        tk_str_copy(range_slider->value_label_style, config->value_label_style);
+  }
+#endif /*RANGE_SLIDER_WITH_LABELS*/
 
   return RET_OK;
 }
 
-static ret_t range_slider_on_paint_self(widget_t* widget, canvas_t* c) {
+/* 直接写入全部配置，只做一次钳位，不分发值改变事件 */
+static ret_t range_slider_apply_config(widget_t* widget, const range_slider_config_t* config) {
   range_slider_t* range_slider = RANGE_SLIDER(widget);
-  return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
-  rect_t br, fr1, fr2;
-  widget_t* dragger1 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_DRAGGER1, TRUE);
-  widget_t* dragger2 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_DRAGGER2, TRUE);
-  return_value_if_fail(dragger1 != NULL && dragger2 != NULL, RET_BAD_PARAMS);
-  widget_t* range_slider_view = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_VIEW, TRUE);
-  return_value_if_fail(range_slider_view != NULL, RET_BAD_PARAMS);
+  return_value_if_fail(range_slider != NULL && config != NULL, RET_BAD_PARAMS);
+
+  /* 新配置中的min/max优先于尚未应用的范围 */
+  range_slider_cancel_pending_bounds(widget);
+  range_slider_store_config(widget, config);
+  range_slider->config_pending = FALSE;
+  /* 与其它设置值的途径一样按step或允许值取整，并保证两个值至少相隔一个step或一个允许值 */
+  range_slider->value1 = range_slider_snap_value(range_slider, range_slider->value1,
+                                                 range_slider->allowed_hint + kDragger1);
+  range_slider->value2 = range_slider_snap_value(range_slider, range_slider->value2,
+                                                 range_slider->allowed_hint + kDragger2);
+  if (!RANGE_SLIDER_SINGLE_THUMB(range_slider) && range_slider->value1 >= range_slider->value2) {
+    double value = range_slider->value2;
+    double lower =
+        range_slider_adjacent_value(range_slider, value, -1, range_slider->allowed_hint + kDragger1);
+    if (lower < value && lower >= range_slider->min) {
+      range_slider->value1 = lower;
+    } else {
+      /* value2已在最小处，改为把value2放到value1的右侧 */
+      double upper =
+          range_slider_adjacent_value(range_slider, value, 1, range_slider->allowed_hint + kDragger2);
+      range_slider->value1 = value;
+      range_slider->value2 = upper <= range_slider->max ? upper : value;
+    }
+  }
+  range_slider_clamp_viewport(range_slider);
+
+  range_slider_ensure_children(widget);
+#if RANGE_SLIDER_WITH_KEYBOARD
+  range_slider_set_focusable(widget, range_slider->range_slider_focusable);
+#endif /*RANGE_SLIDER_WITH_KEYBOARD*/
+  if (range_slider->dragger_style != NULL) {
+    range_slider_set_dragger_style(widget, range_slider->dragger_style);
+  }
+#if RANGE_SLIDER_WITH_LABELS
+  if (range_slider->range_label_style != NULL) {
+    range_slider_set_range_label_style(widget, range_slider->range_label_style);
+  }
+  if (range_slider->value_label_style != NULL) {
+    range_slider_set_value_label_style(widget, range_slider->value_label_style);
+  }
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+  range_slider_update_stats(widget);
 
-  range_slider_check_on_dragger_icon(widget);
-  range_slider_update_dragger_rect(widget, dragger1);
-  range_slider_update_dragger_rect(widget, dragger2);
+  memset(&(range_slider->layout), 0x00, sizeof(range_slider->layout));
+#if RANGE_SLIDER_WITH_LABELS
+  memset(range_slider->label_texts, 0x00, sizeof(range_slider->label_texts));
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+  widget_set_need_relayout_children(widget);
 
-  return_value_if_fail(RET_OK == range_slider_get_bar_rect(widget, &br, &fr1, &fr2),
-                       RET_BAD_PARAMS);
-  range_slider_fill_rect(widget, c, &br, NULL, false);
-  range_slider_fill_rect(widget, c, &fr1, &br, true);
-  if (range_slider->no_use_second_dragger == FALSE)
-    range_slider_fill_rect(widget, c, &fr2, &br, true);
+  return range_slider_invalidate(widget);
+}
 
-  range_slider_update_label(widget, &fr1, &fr2);
-  return RET_OK;
+ret_t range_slider_configure(widget_t* widget, const range_slider_config_t* config) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL && config != NULL, RET_BAD_PARAMS);
+
+  if (widget->loading) {
+    range_slider->config_pending = TRUE;
+    return range_slider_store_config(widget, config);
+  }
+
+  return range_slider_apply_config(widget, config);
 }
 
-static ret_t range_slider_change_value_by_pointer_event(widget_t* widget, pointer_event_t* evt,
-                                                        dragger_index dr_idx) {
+/* 加载过程中属性还不完整(如value1可能先于max到达)，只保存，加载完成后再统一应用 */
+static ret_t range_slider_set_prop_on_loading(widget_t* widget, const char* name,
+                                              const value_t* v) {
+  range_slider_config_t config;
   range_slider_t* range_slider = RANGE_SLIDER(widget);
-  return_value_if_fail(widget != NULL && range_slider != NULL, RET_BAD_PARAMS);
-  widget_t* range_slider_view = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_VIEW, TRUE);
-  return_value_if_fail(range_slider_view != NULL, RET_BAD_PARAMS);
+  return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
 
-  double value = 0;
-  point_t p = {evt->x, evt->y};
-  widget_to_local(range_slider_view, &p);
-  double range = range_slider->max - range_slider->min;
-  uint32_t dragger_size = range_slider_get_dragger_size(widget);
-  int32_t margin =
-      range_slider->no_dragger_icon ? 0 : style_get_int(widget->astyle, STYLE_ID_MARGIN, 0);
-  if (range_slider->no_dragger_icon) {
-    value = range * p.x / range_slider_view_get_width(widget);
-  } else {
-    int32_t half_dragger_size = dragger_size >> 1;
-    //align mouse to the middle of the dragger
-    value =
-        tk_clamp(range * (p.x - half_dragger_size - margin) /
-                     (int32_t)(range_slider_view_get_width(widget) - dragger_size - (margin << 1)),
-                 0.0, range);
+  range_slider_get_config(widget, &config);
+  if (range_slider_config_set_prop(&config, name, v) != RET_OK) {
+    return RET_NOT_FOUND;
   }
-  value += range_slider->min;
-  value = tk_clamp(value, range_slider->min, range_slider->max);
-  event_type_t evt_value_changing =
-      (dr_idx == kDragger1) ? EVT_VALUE1_CHANGING : EVT_VALUE2_CHANGING;
-  return range_slider_set_value_internal(widget, value, evt_value_changing, dr_idx);
+
+  range_slider->config_pending = TRUE;
+  return range_slider_store_config(widget, &config);
 }
 
-static ret_t range_slider_on_event(widget_t* widget, event_t* e) {
+static ret_t range_slider_flush_config(widget_t* widget) {
+  range_slider_config_t config;
   range_slider_t* range_slider = RANGE_SLIDER(widget);
   return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
-  widget_t* dragger1 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_DRAGGER1, TRUE);
-  widget_t* dragger2 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_DRAGGER2, TRUE);
-  widget_t* range_slider_view = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_VIEW, TRUE);
-  if (!(dragger1 != NULL && dragger2 != NULL && range_slider_view != NULL)) {
-    /* 子控件还未初始化完毕，先返回 */
-    return RET_BAD_PARAMS;
+
+  if (!range_slider->config_pending || widget->loading) {
+    return RET_OK;
   }
 
-  pointer_event_t* evt = (pointer_event_t*)e;
-  point_t p = {evt->x, evt->y};
+  range_slider_get_config(widget, &config);
+  return range_slider_apply_config(widget, &config);
+}
+
+static char* range_slider_str_trim(char* str) {
+  char* end = NULL;
+
+  while (*str == ' ' || *str == '\t') {
+    str++;
+  }
+  end = str + strlen(str);
+  while (end > str && (end[-1] == ' ' || end[-1] == '\t')) {
+    *--end = '\0';
+  }
+
+  return str;
+}
+
+/* 解析"name=value;name=value"，名字与属性名相同 */
+static ret_t range_slider_set_config_str(widget_t* widget, const char* str) {
+  value_t v;
   ret_t ret = RET_OK;
-  switch (e->type) {
-    case EVT_POINTER_DOWN: {
-      rect_t *dr1 = (rect_t*)dragger1, *dr2 = (rect_t*)dragger2;
-      widget_to_local(range_slider_view, &p);
-      if (rect_contains(dr1, p.x, p.y)) {
-        range_slider_dispatch_value_change_event(widget, EVT_VALUE1_WILL_CHANGE, kDragger1, 0);
-        range_slider->dragger1_dragging = TRUE;
-        range_slider->dragger2_dragging = FALSE;
-        widget_grab(range_slider_view, dragger1);
-      } else if (rect_contains(dr2, p.x, p.y)) {
-        range_slider_dispatch_value_change_event(widget, EVT_VALUE2_WILL_CHANGE, kDragger2, 0);
-        range_slider->dragger2_dragging = TRUE;
-        range_slider->dragger1_dragging = FALSE;
-        widget_grab(range_slider_view, dragger2);
-      }
-      break;
-    }
-    case EVT_POINTER_MOVE: {
-      if (range_slider->dragger1_dragging) {
-        range_slider_change_value_by_pointer_event(widget, evt, kDragger1);
-      } else if (range_slider->dragger2_dragging) {
-        range_slider_change_value_by_pointer_event(widget, evt, kDragger2);
-      }
-      break;
-    }
-    case EVT_POINTER_UP: {
-      pointer_event_t* evt = (pointer_event_t*)e;
-      if (range_slider->dragger1_dragging) {
-        range_slider->dragger1_dragging = FALSE;
-        range_slider_change_value_by_pointer_event(widget, evt, kDragger1);
-        range_slider_dispatch_value_change_event(widget, EVT_VALUE1_CHANGED, kDragger1, 0);
-        widget_ungrab(range_slider_view, dragger1);
-      } else if (range_slider->dragger2_dragging) {
-        range_slider->dragger2_dragging = FALSE;
-        range_slider_change_value_by_pointer_event(widget, evt, kDragger2);
-        range_slider_dispatch_value_change_event(widget, EVT_VALUE2_CHANGED, kDragger2, 0);
-        widget_ungrab(range_slider_view, dragger2);
-      }
-      break;
+  char* p = NULL;
+  char* buff = NULL;
+  range_slider_config_t config;
+  return_value_if_fail(widget != NULL, RET_BAD_PARAMS);
+
+  if (TK_STR_IS_EMPTY(str)) {
+    return RET_OK;
+  }
+
+  buff = tk_strdup(str);
+  return_value_if_fail(buff != NULL, RET_OOM);
+
+  range_slider_get_config(widget, &config);
+  p = buff;
+  while (p != NULL && *p != '\0') {
+    char* name = p;
+    char* value = NULL;
+    char* next = strchr(p, ';');
+    if (next != NULL) {
+      *next++ = '\0';
     }
-    case EVT_POINTER_LEAVE:
-      widget_set_prop_bool(dragger1, "value", FALSE);
-      widget_set_prop_bool(dragger2, "value", FALSE);
-      break;
-    case EVT_KEY_DOWN:{
-      key_event_t* evt = (key_event_t*)e;
-      const key_type_value_t* kvt = keys_type_find_by_value(evt->key);
-      bool dragger1_selected = widget_get_prop_bool(dragger1, "value", false);
-      bool dragger2_selected = widget_get_prop_bool(dragger2, "value", false);
-
-      if (dragger1_selected) {
-        if (evt->key == TK_KEY_LEFT) {
-          range_slider_dec(widget, kDragger1);
-          ret = RET_STOP;  //用于阻止后继的焦点切换操作，确保按键控制正常执行,下面ret = RET_STOP同理
-        } else if (evt->key == TK_KEY_RIGHT) {
-          range_slider_inc(widget, kDragger1);
-          ret = RET_STOP;
-        } else if (evt->key == TK_KEY_ESCAPE) {
-          widget_set_prop_bool(dragger1, "value", false);
-        }
-      } else if (dragger2_selected) {
-        if (evt->key == TK_KEY_LEFT) {
-          range_slider_dec(widget, kDragger2);
-          ret = RET_STOP;
-        } else if (evt->key == TK_KEY_RIGHT) {
-          range_slider_inc(widget, kDragger2);
-          ret = RET_STOP;
-        } else if (evt->key == TK_KEY_ESCAPE) {
-          widget_set_prop_bool(dragger2, "value", false);
-        }
+
+    value = strchr(name, '=');
+    if (value != NULL) {
+      *value++ = '\0';
+      name = range_slider_str_trim(name);
+      value_set_str(&v, range_slider_str_trim(value));
+      if (range_slider_config_set_prop(&config, name, &v) != RET_OK) {
+        log_debug("range_slider: unknown config \"%s\"\n", name);
+        ret = RET_NOT_FOUND;
       }
-      break;
-    }
-    case EVT_KEY_UP:{
-      break;
     }
-    default:
-      break;
+    p = next;
   }
+
+  /* 样式名指向buff，须在释放之前应用 */
+  range_slider_configure(widget, &config);
+  TKMEM_FREE(buff);
+
   return ret;
 }
 
-static ret_t range_slider_on_layout_children(widget_t* widget) {
-  range_slider_t* range_slider = RANGE_SLIDER(widget);
-  return_value_if_fail(widget != NULL && range_slider != NULL, RET_BAD_PARAMS);
-  widget_t* label_min = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_LABEL_MIN, TRUE);
-  widget_t* label_max = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_LABEL_MAX, TRUE);
-  return_value_if_fail(label_min != NULL && label_max != NULL,RET_BAD_PARAMS);
-  widget_t* dragger1 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_DRAGGER1, TRUE);
-  widget_t* dragger2 = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_DRAGGER2, TRUE);
-  return_value_if_fail(dragger1 != NULL && dragger2 != NULL, RET_BAD_PARAMS);
-  widget_t* range_slider_view = widget_lookup(widget, RANGE_SLIDER_SUB_WIDGET_VIEW, TRUE);
-  return_value_if_fail(range_slider_view != NULL, RET_BAD_PARAMS);
-
-  widget_set_style_str(label_min, "normal:text_align_h", "right");
-  widget_set_style_str(label_min, "focused:text_align_h", "right");
-  widget_set_style_str(label_min, "disabled:text_align_h", "right");
-  widget_set_style_str(label_max, "normal:text_align_h", "left");
-  widget_set_style_str(label_max, "focused:text_align_h", "left");
-  widget_set_style_str(label_max, "disabled:text_align_h", "left");
+static ret_t range_slider_copy_child_layout(widget_t* child, widget_t* other) {
+  return_value_if_fail(child != NULL && other != NULL, RET_BAD_PARAMS);
 
-  char textbuf[10] = {0};
-  if (range_slider->value_min_show_one_point) {
-    sprintf(textbuf, "%.1f", range_slider->min);
-  } else {
-    sprintf(textbuf, "%.f", range_slider->min);
+  widget_move_resize(child, other->x, other->y, other->w, other->h);
+  if (other->text.size > 0) {
+    widget_set_text(child, other->text.str);
   }
-  widget_set_text_utf8(label_min, textbuf);
-  memset(textbuf, 0, sizeof(textbuf));
-
-  sprintf(textbuf, "%.f", range_slider->max);
-  widget_set_text_utf8(label_max, textbuf);
-  memset(textbuf, 0, sizeof(textbuf));
 
-  widget_move_resize(range_slider_view, widget->w / 2 - range_slider_view_get_width(widget) / 2, 0,
-                     range_slider_view_get_width(widget), range_slider_view_get_height(widget));
+  return RET_OK;
+}
 
-  uint32_t range_label_width =
-      (widget->w - range_slider_view_get_width(widget)) / 2 - range_slider->range_label_gap * 2;
-  uint32_t range_label_height = range_slider_view_get_height(widget);
+static ret_t range_slider_on_copy(widget_t* widget, widget_t* other) {
+  range_slider_config_t config;
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  range_slider_t* range_slider_other = RANGE_SLIDER(other);
+  return_value_if_fail(range_slider != NULL && range_slider_other != NULL, RET_BAD_PARAMS);
+
+  range_slider_get_config(other, &config);
+  range_slider_apply_config(widget, &config);
+  range_slider->dataset = range_slider_other->dataset;
+  range_slider->allowed_values = range_slider_other->allowed_values;
+  range_slider->allowed_nr = range_slider_other->allowed_nr;
+  range_slider->view_start = range_slider_other->view_start;
+  range_slider->view_span = range_slider_other->view_span;
+  range_slider_update_stats(widget);
+  if (range_slider_other->index_label != NULL) {
+    range_slider_set_index_labels(widget, range_slider_other->index_label,
+                                  range_slider_other->index_label_ctx);
+  }
 
-  widget_move_resize(label_min, 0, 0, range_label_width, range_label_height);
-  widget_move_resize(label_max, widget->w - range_label_width, 0, range_label_width,
-                     range_label_height);
+  /* 尺寸与模板相同时，布局结果也相同，直接复制，避免重新布局 */
+  if (range_slider_other->layout.valid && widget->w == other->w && widget->h == other->h) {
+    range_slider_copy_child_layout(range_slider->view, range_slider_other->view);
+#if RANGE_SLIDER_WITH_LABELS
+    if (range_slider->label_min != NULL && range_slider_other->label_min != NULL) {
+      range_slider_copy_child_layout(range_slider->label_min, range_slider_other->label_min);
+      range_slider_copy_child_layout(range_slider->label_max, range_slider_other->label_max);
+    }
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+    memcpy(&(range_slider->layout), &(range_slider_other->layout), sizeof(range_slider->layout));
+  }
 
   return RET_OK;
 }
 
-const char* s_range_slider_properties[] = {NULL};
+/* 属性之间有依赖(值需要按min/max钳位)，min/max/step必须排在value1/value2之前 */
+const char* s_range_slider_properties[] = {WIDGET_PROP_MIN,
+                                           WIDGET_PROP_MAX,
+                                           WIDGET_PROP_STEP,
+                                           RANGE_SLIDER_PROP_VALUE1,
+                                           RANGE_SLIDER_PROP_VALUE2,
+                                           WIDGET_PROP_BAR_SIZE,
+                                           RANGE_SLIDER_PROP_DRAGGER_SIZE,
+#if RANGE_SLIDER_WITH_ADAPT_TO_ICON
+                                           RANGE_SLIDER_PROP_DRAGGER_ADAPT_TO_ICON,
+#endif /*RANGE_SLIDER_WITH_ADAPT_TO_ICON*/
+                                           RANGE_SLIDER_PROP_DRAGGER_STYLE,
+#if RANGE_SLIDER_WITH_SECOND_THUMB
+                                           RANGE_SLIDER_PROP_NO_USE_SECOND_DRAGGER,
+#endif /*RANGE_SLIDER_WITH_SECOND_THUMB*/
+#if RANGE_SLIDER_WITH_LABELS
+                                           RANGE_SLIDER_PROP_RANGE_LABEL_VISIBLE,
+                                           RANGE_SLIDER_PROP_VALUE_LABEL_VISIBLE,
+                                           RANGE_SLIDER_PROP_RANGE_LABEL_STYLE,
+                                           RANGE_SLIDER_PROP_VALUE_LABEL_STYLE,
+                                           RANGE_SLIDER_SUB_WIDGET_RANGE_LABEL_GAP,
+                                           RANGE_SLIDER_SUB_WIDGET_VALUE_LABEL_GAP,
+                                           RANGE_SLIDER_SUB_WIDGET_VALUE_LABEL_WIDTH,
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+#if RANGE_SLIDER_WITH_KEYBOARD
+                                           RANGE_SLIDER_PROP_FOCUSABLE,
+#endif /*RANGE_SLIDER_WITH_KEYBOARD*/
+                                           RANGE_SLIDER_PROP_VIEW_WIDTH_RATIO,
+                                           RANGE_SLIDER_PROP_VIEW_HEIGHT_RATIO,
+#if RANGE_SLIDER_WITH_LABELS
+                                           RANGE_SLIDER_PROP_VALUE_MIN_SHOW_ONE_POINT,
+                                           RANGE_SLIDER_PROP_COUNT_LABEL_VISIBLE,
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+                                           RANGE_SLIDER_PROP_FOLLOW,
+                                           RANGE_SLIDER_PROP_OVERVIEW_HEIGHT,
+                                           NULL};
+
+/* 克隆时由on_copy一次性复制全部配置和布局结果，不再逐个set_prop */
+const char* s_range_slider_clone_properties[] = {NULL};
 
 TK_DECL_VTABLE(range_slider) = {.size = sizeof(range_slider_t),
                                 .type = WIDGET_TYPE_RANGE_SLIDER,
-                                .clone_properties = s_range_slider_properties,
+                                .clone_properties = s_range_slider_clone_properties,
                                 .persistent_properties = s_range_slider_properties,
                                 .get_parent_vt = TK_GET_PARENT_VTABLE(widget),
                                 .create = range_slider_create,
+                                .on_copy = range_slider_on_copy,
                                 .on_layout_children = range_slider_on_layout_children,
                                 .on_paint_self = range_slider_on_paint_self,
                                 .on_paint_background = widget_on_paint_null,
@@ -928,10 +3142,350 @@ ret_t range_slider_init_default_style_when_reload(widget_t* widget) {
   range_slider->max = 100;
   range_slider->value1 = 20;
   range_slider->value2 = 50;
+  range_slider->overview_height = RANGE_SLIDER_DEFAULT_OVERVIEW_HEIGHT;
+#if RANGE_SLIDER_WITH_LABELS
+  range_slider->range_label_visible = TRUE;
+  range_slider->value_label_visible = TRUE;
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+
+  return RET_OK;
+}
+
+/* 取消拖动和滑块的选中状态，用于复用实例 */
+static ret_t range_slider_cancel_input(widget_t* widget) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
+  widget_t* dragger1 = range_slider->dragger1;
+  widget_t* dragger2 = RANGE_SLIDER_DRAGGER2(range_slider);
+  widget_t* range_slider_view = range_slider->view;
+  return_value_if_fail(dragger1 != NULL && range_slider_view != NULL, RET_BAD_PARAMS);
+
+  if (range_slider->input_state == RANGE_SLIDER_INPUT_DRAGGING) {
+    widget_ungrab(range_slider_view,
+                  range_slider->active_dragger == kDragger1 ? dragger1 : dragger2);
+  }
+  range_slider->input_state = RANGE_SLIDER_INPUT_IDLE;
+#if RANGE_SLIDER_WITH_KEYBOARD
+  range_slider_release_dragger(dragger1);
+  range_slider_release_dragger(dragger2);
+  range_slider->input_state = RANGE_SLIDER_INPUT_IDLE;
+#endif /*RANGE_SLIDER_WITH_KEYBOARD*/
+
+  memset(range_slider->touches, 0x00, sizeof(range_slider->touches));
+  if (range_slider->touch_idle_id != TK_INVALID_ID) {
+    idle_remove(range_slider->touch_idle_id);
+    range_slider->touch_idle_id = TK_INVALID_ID;
+  }
+  if (window_manager() != NULL) {
+    widget_off_by_ctx(window_manager(), widget);
+  }
+
+  return RET_OK;
+}
+
+ret_t range_slider_rebind(widget_t* widget, const range_slider_config_t* config) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL && config != NULL, RET_BAD_PARAMS);
+
+  range_slider_cancel_input(widget);
+  return range_slider_apply_config(widget, config);
+}
+
+ret_t range_slider_reset(widget_t* widget) {
+  range_slider_config_t config;
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
+
+  /* 与range_slider_create之后的状态一致 */
+  memset(&config, 0x00, sizeof(config));
+  config.min = 0;
+  config.max = 100;
+  config.value1 = 20;
+  config.value2 = 50;
+  config.overview_height = RANGE_SLIDER_DEFAULT_OVERVIEW_HEIGHT;
+  config.range_label_visible = TRUE;
+  config.value_label_visible = TRUE;
+
+  memset(&(range_slider->dataset), 0x00, sizeof(range_slider->dataset));
+  range_slider->view_span = 0;
+  range_slider->allowed_values = NULL;
+  range_slider->allowed_nr = 0;
+  range_slider->index_label = NULL;
+  range_slider->index_label_ctx = NULL;
+  range_slider->snapshot = NULL;
+  return range_slider_rebind(widget, &config);
+}
+
+/*
+ * 状态记录的格式(本机字节序)：
+ *   uint8  version
+ *   uint8  flags
+ *   uint16 size    后续数据的字节数，新版本只在末尾追加字段，旧版本读取时跳过不认识的部分
+ *   double value1, value2, min, max, step, view_start, view_span
+ * 多个控件的状态前面加上uint32的magic和uint32的记录个数。
+ */
+#define RANGE_SLIDER_STATE_VERSION 1
+#define RANGE_SLIDER_STATE_MAGIC 0x54535352 /* "RSST" */
+#define RANGE_SLIDER_STATE_FLAG_FOLLOW 0x01
+#define RANGE_SLIDER_STATE_FLAG_SINGLE_THUMB 0x02
+
+typedef struct _range_slider_state_t {
+  uint8_t flags;
+  double value1;
+  double value2;
+  double min;
+  double max;
+  double step;
+  double view_start;
+  double view_span;
+} range_slider_state_t;
+
+#define RANGE_SLIDER_STATE_DATA_SIZE (7 * sizeof(double))
+
+ret_t range_slider_save_state(widget_t* widget, wbuffer_t* wb) {
+  uint8_t flags = 0;
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL && wb != NULL, RET_BAD_PARAMS);
+
+  range_slider_flush_config(widget);
+  if (range_slider->follow) {
+    flags |= RANGE_SLIDER_STATE_FLAG_FOLLOW;
+  }
+  if (RANGE_SLIDER_SINGLE_THUMB(range_slider)) {
+    flags |= RANGE_SLIDER_STATE_FLAG_SINGLE_THUMB;
+  }
+
+  return_value_if_fail(wbuffer_extend_capacity(wb, wb->cursor + 4 + RANGE_SLIDER_STATE_DATA_SIZE) ==
+                           RET_OK,
+                       RET_OOM);
+  wbuffer_write_uint8(wb, RANGE_SLIDER_STATE_VERSION);
+  wbuffer_write_uint8(wb, flags);
+  wbuffer_write_uint16(wb, RANGE_SLIDER_STATE_DATA_SIZE);
+  /* 跟随模式下尚未应用的范围也一并保存 */
+  wbuffer_write_double(wb, range_slider->value1);
+  wbuffer_write_double(wb, range_slider->value2);
+  wbuffer_write_double(wb, RANGE_SLIDER_MIN(range_slider));
+  wbuffer_write_double(wb, RANGE_SLIDER_MAX(range_slider));
+  wbuffer_write_double(wb, range_slider->step);
+  wbuffer_write_double(wb, range_slider->view_start);
+
+  return wbuffer_write_double(wb, range_slider->view_span);
+}
+
+static ret_t range_slider_read_state(rbuffer_t* rb, range_slider_state_t* state) {
+  uint8_t version = 0;
+  uint16_t size = 0;
+  return_value_if_fail(rbuffer_read_uint8(rb, &version) == RET_OK, RET_BAD_PARAMS);
+  return_value_if_fail(rbuffer_read_uint8(rb, &(state->flags)) == RET_OK, RET_BAD_PARAMS);
+  return_value_if_fail(rbuffer_read_uint16(rb, &size) == RET_OK, RET_BAD_PARAMS);
+  return_value_if_fail(version >= 1 && size >= RANGE_SLIDER_STATE_DATA_SIZE, RET_BAD_PARAMS);
+  return_value_if_fail(rb->cursor + size <= rb->capacity, RET_BAD_PARAMS);
+
+  rbuffer_read_double(rb, &(state->value1));
+  rbuffer_read_double(rb, &(state->value2));
+  rbuffer_read_double(rb, &(state->min));
+  rbuffer_read_double(rb, &(state->max));
+  rbuffer_read_double(rb, &(state->step));
+  rbuffer_read_double(rb, &(state->view_start));
+  rbuffer_read_double(rb, &(state->view_span));
+  rbuffer_skip(rb, size - RANGE_SLIDER_STATE_DATA_SIZE);
+
+  /* NaN和颠倒的范围都不接受 */
+  return_value_if_fail(state->min <= state->max && state->step >= 0 && state->view_span >= 0,
+                       RET_BAD_PARAMS);
+  return_value_if_fail(!isnan(state->value1) && !isnan(state->value2) &&
+                           !isnan(state->view_start),
+                       RET_BAD_PARAMS);
+
+  return RET_OK;
+}
+
+/* 直接设置各个字段，与range_slider_apply_bounds一样只就地更新范围label，invalidate为FALSE时由调用者统一刷新 */
+static ret_t range_slider_restore_state(widget_t* widget, const range_slider_state_t* state,
+                                        bool_t invalidate) {
+  double value1 = 0;
+  double value2 = 0;
+  bool_t changed = FALSE;
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL && state != NULL, RET_BAD_PARAMS);
+
+  range_slider_flush_config(widget);
+  range_slider_cancel_pending_bounds(widget);
+  range_slider->follow = (state->flags & RANGE_SLIDER_STATE_FLAG_FOLLOW) != 0;
+#if RANGE_SLIDER_WITH_SECOND_THUMB
+  if (range_slider->no_use_second_dragger !=
+      ((state->flags & RANGE_SLIDER_STATE_FLAG_SINGLE_THUMB) != 0)) {
+    range_slider->no_use_second_dragger = !range_slider->no_use_second_dragger;
+    range_slider_ensure_children(widget);
+  }
+#endif /*RANGE_SLIDER_WITH_SECOND_THUMB*/
+
+  range_slider->min = state->min;
+  range_slider->max = state->max;
+  range_slider->step = state->step;
+#if RANGE_SLIDER_WITH_LABELS
+  range_slider_update_range_labels(widget, FALSE);
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+  if (range_slider->layout.valid) {
+    range_slider->layout.min = state->min;
+    range_slider->layout.max = state->max;
+  }
+  range_slider->view_start = state->view_start;
+  range_slider->view_span = state->view_span;
+  range_slider_clamp_viewport(range_slider);
+
+  value1 = range_slider_snap_value(range_slider, state->value1,
+                                   range_slider->allowed_hint + kDragger1);
+  value2 = range_slider_snap_value(range_slider, state->value2,
+                                   range_slider->allowed_hint + kDragger2);
+  if (!RANGE_SLIDER_SINGLE_THUMB(range_slider) && value1 > value2) {
+    value1 = value2;
+  }
+  changed = value1 != range_slider->value1 || value2 != range_slider->value2;
+  range_slider->value1 = value1;
+  range_slider->value2 = value2;
+  range_slider_update_stats(widget);
+  if (invalidate) {
+    range_slider_invalidate(widget);
+  }
+
+  return changed ? range_slider_notify_range(widget, RANGE_SLIDER_PHASE_CHANGED) : RET_OK;
+}
+
+ret_t range_slider_load_state(widget_t* widget, rbuffer_t* rb) {
+  range_slider_state_t state;
+  return_value_if_fail(RANGE_SLIDER(widget) != NULL && rb != NULL, RET_BAD_PARAMS);
+  return_value_if_fail(range_slider_read_state(rb, &state) == RET_OK, RET_BAD_PARAMS);
+
+  return range_slider_restore_state(widget, &state, TRUE);
+}
+
+typedef struct _range_slider_states_ctx_t {
+  wbuffer_t* wb;
+  rbuffer_t* rb;
+  /* 保存时为已写入的个数，恢复时为剩余的记录个数 */
+  uint32_t nr;
+  ret_t ret;
+} range_slider_states_ctx_t;
+
+static ret_t range_slider_on_save_state(void* ctx, const void* data) {
+  widget_t* widget = WIDGET(data);
+  range_slider_states_ctx_t* info = (range_slider_states_ctx_t*)ctx;
+
+  if (!WIDGET_IS_INSTANCE_OF(widget, range_slider)) {
+    return RET_OK;
+  }
+
+  info->ret = range_slider_save_state(widget, info->wb);
+  info->nr++;
+
+  return info->ret == RET_OK ? RET_OK : RET_STOP;
+}
+
+static ret_t range_slider_on_load_state(void* ctx, const void* data) {
+  range_slider_state_t state;
+  widget_t* widget = WIDGET(data);
+  range_slider_states_ctx_t* info = (range_slider_states_ctx_t*)ctx;
+
+  if (!WIDGET_IS_INSTANCE_OF(widget, range_slider)) {
+    return RET_OK;
+  }
+  if (info->nr == 0) {
+    /* 控件比记录多 */
+    info->ret = RET_NOT_FOUND;
+    return RET_STOP;
+  }
+
+  info->nr--;
+  info->ret = range_slider_read_state(info->rb, &state);
+  if (info->ret != RET_OK) {
+    return RET_STOP;
+  }
+  range_slider_restore_state(widget, &state, FALSE);
+
+  return RET_OK;
+}
+
+ret_t range_slider_save_states(widget_t* root, wbuffer_t* wb) {
+  uint32_t offset = 0;
+  range_slider_states_ctx_t info;
+  return_value_if_fail(root != NULL && wb != NULL, RET_BAD_PARAMS);
+
+  memset(&info, 0x00, sizeof(info));
+  info.wb = wb;
+  info.ret = RET_OK;
+  return_value_if_fail(wbuffer_write_uint32(wb, RANGE_SLIDER_STATE_MAGIC) == RET_OK, RET_OOM);
+  /* 个数在遍历完成后回填 */
+  offset = wb->cursor;
+  return_value_if_fail(wbuffer_write_uint32(wb, 0) == RET_OK, RET_OOM);
+
+  widget_foreach(root, range_slider_on_save_state, &info);
+  return_value_if_fail(info.ret == RET_OK, info.ret);
+  memcpy(wb->data + offset, &(info.nr), sizeof(info.nr));
 
   return RET_OK;
 }
 
+/* 先检查全部记录，有一个不完整或无效时整个缓冲区都不应用 */
+static ret_t range_slider_check_states(rbuffer_t* rb, uint32_t nr) {
+  uint32_t i = 0;
+  range_slider_state_t state;
+
+  for (i = 0; i < nr; i++) {
+    if (range_slider_read_state(rb, &state) != RET_OK) {
+      return RET_BAD_PARAMS;
+    }
+  }
+
+  return RET_OK;
+}
+
+ret_t range_slider_load_states(widget_t* root, rbuffer_t* rb) {
+  uint32_t magic = 0;
+  uint32_t start = 0;
+  uint32_t records = 0;
+  uint32_t end = 0;
+  range_slider_states_ctx_t info;
+  return_value_if_fail(root != NULL && rb != NULL, RET_BAD_PARAMS);
+
+  memset(&info, 0x00, sizeof(info));
+  info.rb = rb;
+  info.ret = RET_OK;
+  start = rb->cursor;
+  if (rbuffer_read_uint32(rb, &magic) != RET_OK || magic != RANGE_SLIDER_STATE_MAGIC ||
+      rbuffer_read_uint32(rb, &(info.nr)) != RET_OK) {
+    rb->cursor = start;
+    return RET_BAD_PARAMS;
+  }
+
+  records = rb->cursor;
+  if (range_slider_check_states(rb, info.nr) != RET_OK) {
+    rb->cursor = start;
+    return RET_BAD_PARAMS;
+  }
+  end = rb->cursor;
+  rb->cursor = records;
+
+  widget_foreach(root, range_slider_on_load_state, &info);
+  widget_invalidate(root, NULL);
+  /* 没用到的记录也要跳过，调用者可以接着读后面的数据 */
+  rb->cursor = end;
+  if (info.ret == RET_OK && info.nr != 0) {
+    /* 记录比控件多 */
+    info.ret = RET_NOT_FOUND;
+  }
+
+  return info.ret;
+}
+
+range_slider_range_event_t* range_slider_range_event_cast(event_t* event) {
+  return_value_if_fail(event != NULL, NULL);
+  return_value_if_fail(event->type == EVT_RANGE_CHANGED, NULL);
+  return_value_if_fail(event->size == sizeof(range_slider_range_event_t), NULL);
+
+  return (range_slider_range_event_t*)event;
+}
+
 widget_t* range_slider_create(widget_t* parent, xy_t x, xy_t y, wh_t w, wh_t h) {
   widget_t* widget = widget_create(parent, TK_REF_VTABLE(range_slider), x, y, w, h);
   range_slider_t* range_slider = RANGE_SLIDER(widget);
@@ -939,31 +3493,125 @@ widget_t* range_slider_create(widget_t* parent, xy_t x, xy_t y, wh_t w, wh_t h)
   widget_t* range_slider_view = view_create(widget, 0, 0, 0, 0);
   return_value_if_fail(range_slider_view != NULL, NULL);
 
-  widget_t* dragger1 = check_button_create_radio(range_slider_view, 0, 0, 0, 0);
-  widget_t* dragger2 = check_button_create_radio(range_slider_view, 0, 0, 0, 0);
-  return_value_if_fail(dragger1 != NULL && dragger2 != NULL, NULL);
+  widget_set_name(range_slider_view, RANGE_SLIDER_SUB_WIDGET_VIEW);
+  /* 内部子控件不参与克隆和序列化 */
+  range_slider_view->auto_created = TRUE;
+  range_slider->view = range_slider_view;
+
+  /* dragger2和各个label由range_slider_ensure_children按需创建 */
+  range_slider->dragger1 = range_slider_create_dragger(widget, RANGE_SLIDER_SUB_WIDGET_DRAGGER1);
+  return_value_if_fail(range_slider->dragger1 != NULL, NULL);
 
-  widget_t* label_min = label_create(widget, 0, 0, 0, 0);
-  widget_t* label_max = label_create(widget, 0, 0, 0, 0);
-  widget_t* label_value1 = label_create(widget, 0, 0, 0, 0);
-  widget_t* label_value2 = label_create(widget, 0, 0, 0, 0);
-  return_value_if_fail(
-      label_min != NULL && label_max != NULL && label_value1 != NULL && label_value2 != NULL, NULL);
+  if (window_manager() != NULL && s_range_slider_touch_down_id == TK_INVALID_ID) {
+    s_range_slider_touch_down_id =
+        widget_on(window_manager(), EVT_TOUCH_DOWN, range_slider_on_wm_touch_down, NULL);
+  }
+  s_range_slider_nr++;
 
-  widget_set_name(range_slider_view, RANGE_SLIDER_SUB_WIDGET_VIEW);
-  widget_set_name(dragger1, RANGE_SLIDER_SUB_WIDGET_DRAGGER1);
-  widget_set_name(dragger2, RANGE_SLIDER_SUB_WIDGET_DRAGGER2);
-  widget_set_name(label_min, RANGE_SLIDER_SUB_WIDGET_LABEL_MIN);
-  widget_set_name(label_max, RANGE_SLIDER_SUB_WIDGET_LABEL_MAX);
-  widget_set_name(label_value1, RANGE_SLIDER_SUB_WIDGET_LABEL_VALUE1);
-  widget_set_name(label_value2, RANGE_SLIDER_SUB_WIDGET_LABEL_VALUE2);
-
-  widget_on(dragger1, EVT_KEY_DOWN, on_dragger_key_down, range_slider);
-  widget_on(dragger2, EVT_KEY_DOWN, on_dragger_key_down, range_slider);
   range_slider_init_default_style_when_reload(widget);
   return widget;
 }
 
+ret_t range_slider_set_dataset(widget_t* widget, const double* data, const double* prefix_sum,
+                               uint32_t nr) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
+
+  memset(&range_slider->dataset, 0x00, sizeof(range_slider->dataset));
+  if (data != NULL) {
+    range_slider->dataset.data = data;
+    range_slider->dataset.prefix_sum = prefix_sum;
+    range_slider->dataset.nr = nr;
+  }
+  range_slider_update_stats(widget);
+
+  return range_slider_invalidate(widget);
+}
+
+ret_t range_slider_set_histogram(widget_t* widget, double start, double bin_width,
+                                 const double* prefix_count, const double* prefix_sum,
+                                 uint32_t bins) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
+  return_value_if_fail(prefix_count == NULL || bin_width > 0, RET_BAD_PARAMS);
+
+  memset(&range_slider->dataset, 0x00, sizeof(range_slider->dataset));
+  if (prefix_count != NULL) {
+    range_slider->dataset.prefix_count = prefix_count;
+    range_slider->dataset.prefix_sum = prefix_sum;
+    range_slider->dataset.nr = bins;
+    range_slider->dataset.start = start;
+    range_slider->dataset.bin_width = bin_width;
+  }
+  range_slider_update_stats(widget);
+
+  return range_slider_invalidate(widget);
+}
+
+ret_t range_slider_set_allowed_values(widget_t* widget, const double* values, uint32_t nr) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
+
+  range_slider->allowed_values = (values != NULL && nr > 0) ? values : NULL;
+  range_slider->allowed_nr = range_slider->allowed_values != NULL ? nr : 0;
+  range_slider->allowed_hint[0] = 0;
+  range_slider->allowed_hint[1] = 0;
+
+  if (range_slider->allowed_values != NULL) {
+    range_slider->value1 =
+        range_slider_snap_allowed(range_slider, range_slider->value1, range_slider->allowed_hint);
+    range_slider->value2 = range_slider_snap_allowed(range_slider, range_slider->value2,
+                                                     range_slider->allowed_hint + 1);
+    if (!RANGE_SLIDER_SINGLE_THUMB(range_slider) && range_slider->value1 >= range_slider->value2) {
+      range_slider->value1 = range_slider_adjacent_value(range_slider, range_slider->value2, -1,
+                                                         range_slider->allowed_hint);
+    }
+  }
+  range_slider_update_stats(widget);
+
+  return range_slider_invalidate(widget);
+}
+
+ret_t range_slider_set_index_labels(widget_t* widget, range_slider_index_label_t label,
+                                    void* ctx) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
+
+#if RANGE_SLIDER_WITH_LABELS
+  if (label != NULL && range_slider->index_cache == NULL) {
+    range_slider->index_cache = TKMEM_ZALLOC(range_slider_index_cache_t);
+    return_value_if_fail(range_slider->index_cache != NULL, RET_OOM);
+  }
+  if (range_slider->index_cache != NULL) {
+    memset(range_slider->index_cache, 0x00, sizeof(*(range_slider->index_cache)));
+  }
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+  range_slider->index_label = label;
+  range_slider->index_label_ctx = ctx;
+
+  if (label != NULL) {
+    /* 索引只能是整数 */
+    range_slider->step = tk_max(1, tk_roundi(range_slider->step));
+    range_slider_set_range(widget, range_slider->value1, range_slider->value2, FALSE);
+  }
+
+#if RANGE_SLIDER_WITH_LABELS
+  memset(range_slider->label_texts, 0x00, sizeof(range_slider->label_texts));
+  range_slider_update_range_labels(widget, TRUE);
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+
+  return range_slider_invalidate(widget);
+}
+
+ret_t range_slider_set_snapshot(widget_t* widget, range_slider_snapshot_t* snapshot) {
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(range_slider != NULL, RET_BAD_PARAMS);
+
+  range_slider->snapshot = snapshot;
+
+  return range_slider_publish_snapshot(range_slider);
+}
+
 widget_t* range_slider_cast(widget_t* widget) {
   return_value_if_fail(WIDGET_IS_INSTANCE_OF(widget, range_slider), NULL);
 
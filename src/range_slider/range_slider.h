@@ -23,10 +23,180 @@
 #ifndef TK_RANGE_SLIDER_H
 #define TK_RANGE_SLIDER_H
 
+#include "tkc/buffer.h"
 #include "base/widget.h"
 #include "widgets/dragger.h"
+#include "range_slider_dataset.h"
+#include "range_slider_snapshot.h"
 
 BEGIN_C_DECLS
+
+struct _range_slider_pool_t;
+struct _range_slider_index_cache_t;
+
+/**
+ * 索引模式下生成label文本的回调，text为UTF-8，超出size时截断。
+ * 只在需要显示某个索引(两端的范围label和滑块的值label)时调用，最近用过的文本会被缓存。
+ */
+typedef ret_t (*range_slider_index_label_t)(void* ctx, uint32_t index, char* text,
+                                            uint32_t size);
+
+/*
+ * 功能裁剪：定义为0时去掉对应的代码、成员、属性和子控件，用于flash/RAM受限的平台。
+ * 缺省全部打开，与不定义时的行为一致。
+ */
+
+/* min/max/value label及区间计数的显示 */
+#ifndef RANGE_SLIDER_WITH_LABELS
+#define RANGE_SLIDER_WITH_LABELS 1
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+
+/* 键盘操作(焦点、选中、方向键调整值) */
+#ifndef RANGE_SLIDER_WITH_KEYBOARD
+#define RANGE_SLIDER_WITH_KEYBOARD 1
+#endif /*RANGE_SLIDER_WITH_KEYBOARD*/
+
+/* 第二个滑块，关闭后只能作为单滑块使用(区间为[min, value1]) */
+#ifndef RANGE_SLIDER_WITH_SECOND_THUMB
+#define RANGE_SLIDER_WITH_SECOND_THUMB 1
+#endif /*RANGE_SLIDER_WITH_SECOND_THUMB*/
+
+/* 滑轨的圆角(round_radius样式) */
+#ifndef RANGE_SLIDER_WITH_ROUND
+#define RANGE_SLIDER_WITH_ROUND 1
+#endif /*RANGE_SLIDER_WITH_ROUND*/
+
+/* 滑块尺寸与图标适应(dragger_adapt_to_icon属性) */
+#ifndef RANGE_SLIDER_WITH_ADAPT_TO_ICON
+#define RANGE_SLIDER_WITH_ADAPT_TO_ICON 1
+#endif /*RANGE_SLIDER_WITH_ADAPT_TO_ICON*/
+
+#if RANGE_SLIDER_WITH_SECOND_THUMB
+#define RANGE_SLIDER_THUMB_NR 2
+#else
+#define RANGE_SLIDER_THUMB_NR 1
+#endif /*RANGE_SLIDER_WITH_SECOND_THUMB*/
+
+/* 当前状态下解析好的样式，绘制和拖动时直接读取，避免反复查询style */
+typedef struct _range_slider_style_cache_t {
+  bool_t valid;
+  /* 解析时的状态，任一变化都需要重新解析 */
+  style_t* astyle;
+  const char* state;
+  const char* dragger_state;
+
+  color_t bg_color;
+  color_t fg_color;
+#if RANGE_SLIDER_WITH_ROUND
+  int32_t round_radius;
+#endif /*RANGE_SLIDER_WITH_ROUND*/
+  int32_t margin;
+  bool_t dragger_has_image;
+#if RANGE_SLIDER_WITH_ADAPT_TO_ICON
+  uint32_t dragger_image_w;
+#endif /*RANGE_SLIDER_WITH_ADAPT_TO_ICON*/
+  bool_t no_dragger_icon;
+} range_slider_style_cache_t;
+
+/* 上一次布局的输入，输入未变化时跳过布局 */
+typedef struct _range_slider_layout_t {
+  bool_t valid;
+  wh_t w;
+  wh_t h;
+  double width_ratio;
+  double height_ratio;
+  double min;
+  double max;
+#if RANGE_SLIDER_WITH_LABELS
+  uint32_t range_label_gap;
+  bool_t value_min_show_one_point;
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+} range_slider_layout_t;
+
+#if RANGE_SLIDER_WITH_LABELS
+/* 值label上次显示的内容，内容不变时不重设文本 */
+typedef struct _range_slider_label_text_t {
+  bool_t valid;
+  bool_t with_count;
+  uint32_t count;
+  double value;
+  /* 两个值label重叠时合并显示为"value1 – value2" */
+  bool_t merged;
+  double value2;
+} range_slider_label_text_t;
+
+/* 值label中可能出现的字符的宽度(样式改变后重新测量)，及据此算出的自动宽度 */
+typedef struct _range_slider_label_metrics_t {
+  bool_t valid;
+  float_t digit;
+  float_t minus;
+  float_t space;
+  float_t parens;
+  float_t dash;
+  /* 自动宽度及计算时的范围和格式，任一变化都需要重新计算 */
+  uint32_t width;
+  double min;
+  double max;
+  bool_t with_count;
+  uint32_t total;
+} range_slider_label_metrics_t;
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+
+/* 键盘和指针输入的状态，按键和指针事件只根据它处理 */
+typedef enum _range_slider_input_state_t {
+  RANGE_SLIDER_INPUT_IDLE = 0,
+  /* 滑块获得焦点 */
+  RANGE_SLIDER_INPUT_FOCUSED,
+  /* 滑块被选中，左右键调整值 */
+  RANGE_SLIDER_INPUT_GRABBED,
+  /* 指针拖动中 */
+  RANGE_SLIDER_INPUT_DRAGGING
+} range_slider_input_state_t;
+
+/* 一个手指拖动一个滑块 */
+typedef struct _range_slider_touch_t {
+  bool_t active;
+  int64_t finger_id;
+  double start_value;
+  /* 本帧内最新的值，在idle中与另一个滑块合并更新 */
+  double pending_value;
+  bool_t pending;
+} range_slider_touch_t;
+
+/**
+ * @class range_slider_config_t
+ * @annotation ["scriptable"]
+ * range_slider的全部配置，用于一次性获取和设置。
+ * 字段含义与range_slider_t的同名属性相同，样式名为NULL时表示保持不变。
+ * 各种功能裁剪下布局都不变，被裁剪的功能对应的字段被忽略。
+ */
+typedef struct _range_slider_config_t {
+  double value1;
+  double value2;
+  double min;
+  double max;
+  double step;
+  uint32_t bar_size;
+  uint32_t dragger_size;
+  const char* dragger_style;
+  const char* range_label_style;
+  const char* value_label_style;
+  bool_t dragger_adapt_to_icon;
+  bool_t no_use_second_dragger;
+  bool_t range_label_visible;
+  bool_t value_label_visible;
+  uint32_t range_label_gap;
+  uint32_t value_label_gap;
+  uint32_t value_label_width;
+  double range_slider_view_width_ratio;
+  double range_slider_view_height_ratio;
+  bool_t range_slider_focusable;
+  bool_t value_min_show_one_point;
+  bool_t count_label_visible;
+  bool_t follow;
+  uint32_t overview_height;
+} range_slider_config_t;
+
 /**
  * @class range_slider_t
  * @parent widget_t
@@ -137,14 +307,15 @@ typedef struct _range_slider_t {
    * @annotation ["set_prop","get_prop","readable","persitent","design","scriptable"]
    * 渲染dragger的style名称, 目前使用radio_button的style, 默认为default, 可通过自定义radio_button的style来定制。
    */
-  const char* dragger_style;
+  char* dragger_style;
 
+#if RANGE_SLIDER_WITH_LABELS
   /**
    * @property {char*} range_label_style
    * @annotation ["set_prop","get_prop","readable","persitent","design","scriptable"]
    * 设置标识min和max的label的样式, 默认为default, 注意：text_align_h样式默认定死为right和left,无法修改。
    */
-  const char* range_label_style;
+  char* range_label_style;
 
   
   /**
@@ -152,23 +323,28 @@ typedef struct _range_slider_t {
    * @annotation ["set_prop","get_prop","readable","persitent","design","scriptable"]
    * 设置标识value1和value2的label的样式, 默认为default
    */
-  const char* value_label_style;
-
+  char* value_label_style;
+#endif /*RANGE_SLIDER_WITH_LABELS*/
 
+#if RANGE_SLIDER_WITH_ADAPT_TO_ICON
   /**
    * @property {bool_t} dragger_adapt_to_icon
    * @annotation ["set_prop","get_prop","readable","persitent","design","scriptable"]
    * 滑块的宽度或高度是否与icon适应，缺省为true。
    */
   bool_t dragger_adapt_to_icon;
+#endif /*RANGE_SLIDER_WITH_ADAPT_TO_ICON*/
 
+#if RANGE_SLIDER_WITH_SECOND_THUMB
   /**
    * @property {bool_t} no_use_second_dragger
    * @annotation ["set_prop","get_prop","readable","persitent","design","scriptable"]
    * 禁止使用第二个dragger，缺省为false。
    */
   bool_t no_use_second_dragger;
+#endif /*RANGE_SLIDER_WITH_SECOND_THUMB*/
 
+#if RANGE_SLIDER_WITH_LABELS
   /**
    * @property {bool_t} range_label_visible
    * @annotation ["set_prop","get_prop","readable","persitent","design","scriptable"]
@@ -200,9 +376,11 @@ typedef struct _range_slider_t {
    /**
    * @property {uint32_t} value_label_width
    * @annotation ["set_prop","get_prop","readable","persitent","design","scriptable"]
-   * 标识value1和value2的label宽度，默认为50
+   * 标识value1和value2的label宽度，默认为50，为0时按当前范围和格式下最宽的文本自动计算。
+   * 两个label重叠时合并为一个，显示"value1 – value2"。
    */
   uint32_t value_label_width;
+#endif /*RANGE_SLIDER_WITH_LABELS*/
 
   /**
    * @property {double} range_slider_view_width_ratio
@@ -218,14 +396,16 @@ typedef struct _range_slider_t {
    */
   double range_slider_view_height_ratio;
 
-
+#if RANGE_SLIDER_WITH_KEYBOARD
   /**
    * @property {bool_t} range_slider_focusable
    * @annotation ["set_prop","get_prop","readable","persitent","design","scriptable"]
    * 是否允许控件range_slider获得焦点，由于某些原因widget的focusable无法得到预想的效果，因此focusable应以这个为准，缺省为false
    */
   bool_t range_slider_focusable;
-  
+#endif /*RANGE_SLIDER_WITH_KEYBOARD*/
+
+#if RANGE_SLIDER_WITH_LABELS
   /**
    * @property {bool_t} value_min_show_one_point
    * @annotation ["set_prop","get_prop","readable","persitent","design","scriptable"]
@@ -233,11 +413,113 @@ typedef struct _range_slider_t {
    */
   bool_t value_min_show_one_point;
 
+  /**
+   * @property {bool_t} count_label_visible
+   * @annotation ["set_prop","get_prop","readable","persitent","design","scriptable"]
+   * 是否在value label中显示区间内的数据个数(需先关联数据集)，缺省为false
+   */
+  bool_t count_label_visible;
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+
+  /**
+   * @property {uint32_t} count_in_range
+   * @annotation ["get_prop","readable","scriptable"]
+   * 关联数据集中落在当前区间内的数据个数(只读)。
+   */
+  uint32_t count_in_range;
+
+  /**
+   * @property {double} sum_in_range
+   * @annotation ["get_prop","readable","scriptable"]
+   * 关联数据集中落在当前区间内的数据之和(只读)，关联时未提供前缀和则为0。
+   */
+  double sum_in_range;
+
+  /**
+   * @property {double} mean_in_range
+   * @annotation ["get_prop","readable","scriptable"]
+   * 关联数据集中落在当前区间内的数据平均值(只读)，关联时未提供前缀和则为0。
+   */
+  double mean_in_range;
+
+  /**
+   * @property {bool_t} follow
+   * @annotation ["set_prop","get_prop","readable","persitent","design","scriptable"]
+   * 跟随模式，用于在不断增长的实时数据上选择时间窗口，缺省为false。
+   * 打开后，设置min/max只记录下来，每帧合并应用一次；max增长时，贴在max上的窗口随之平移(保持宽度)。
+   */
+  bool_t follow;
+
+  /**
+   * @property {double} view_start
+   * @annotation ["set_prop","get_prop","readable","scriptable"]
+   * 缩放时主滑轨显示的子区间的起点。
+   */
+  double view_start;
+
+  /**
+   * @property {double} view_span
+   * @annotation ["set_prop","get_prop","readable","scriptable"]
+   * 缩放时主滑轨显示的子区间的长度，为0时不缩放(显示整个[min, max])。
+   */
+  double view_span;
+
+  /**
+   * @property {uint32_t} overview_height
+   * @annotation ["set_prop","get_prop","readable","persitent","design","scriptable"]
+   * 缩放时在view底部显示的概览条的高度(整个范围及当前显示的区间)，为0时不显示，缺省为4。
+   */
+  uint32_t overview_height;
+
   /* private */
+  widget_t* view;
+  widget_t* dragger1;
+  /* dragger2和各个label按需创建，不需要时为NULL */
+#if RANGE_SLIDER_WITH_SECOND_THUMB
+  widget_t* dragger2;
+#endif /*RANGE_SLIDER_WITH_SECOND_THUMB*/
+#if RANGE_SLIDER_WITH_LABELS
+  widget_t* label_min;
+  widget_t* label_max;
+  widget_t* label_value1;
+  widget_t* label_value2;
+  range_slider_label_text_t label_texts[2];
+  range_slider_label_metrics_t label_metrics;
+#endif /*RANGE_SLIDER_WITH_LABELS*/
+  range_slider_dataset_t dataset;
+  range_slider_style_cache_t style_cache;
+  range_slider_layout_t layout;
   bool_t no_dragger_icon;
-  bool_t dragger1_dragging;
-  bool_t dragger2_dragging;
+  range_slider_input_state_t input_state;
+  /* 当前获得焦点、被选中或正在拖动的滑块，0为dragger1，1为dragger2 */
+  uint32_t active_dragger;
   bool_t auto_get_dragger_size;
+  /* 加载过程中设置的属性只保存，加载完成后一次性应用 */
+  bool_t config_pending;
+  /* 拖动开始时的值，拖动结束时作为EVT_VALUEx_CHANGED的旧值 */
+  double drag_start_value;
+  /* 多点触摸，按滑块索引 */
+  range_slider_touch_t touches[RANGE_SLIDER_THUMB_NR];
+  uint32_t touch_idle_id;
+  /* 上一次绘制滑轨时的填充次数(OpenGL下为draw call数)，用于性能测试 */
+  uint32_t track_draw_calls;
+  /* 所属的预分配池，不在池中时为NULL */
+  struct _range_slider_pool_t* pool;
+  /* 允许的取值(升序，引用调用者的数组)，为NULL时按step取整 */
+  const double* allowed_values;
+  uint32_t allowed_nr;
+  /* 两个值在allowed_values中的位置，用于O(1)地找到相邻的允许值 */
+  uint32_t allowed_hint[2];
+  /* 跟随模式下尚未应用的min/max，在idle中合并应用 */
+  double pending_min;
+  double pending_max;
+  uint32_t bounds_idle_id;
+  /* 索引模式：min/max/value都是索引，label文本由回调生成，为NULL时显示数值 */
+  range_slider_index_label_t index_label;
+  void* index_label_ctx;
+  struct _range_slider_index_cache_t* index_cache;
+  /* 发布区间供其它线程读取，由调用者提供，为NULL时不发布 */
+  range_slider_snapshot_t* snapshot;
 } range_slider_t;
 
 /**
@@ -277,6 +559,96 @@ typedef struct _range_slider_t {
 #define EVT_VALUE2_CHANGING (EVT_USER_START + 5)
 #define EVT_VALUE2_CHANGED (EVT_USER_START + 6)
 
+/**
+ * @event {range_slider_range_event_t} EVT_RANGE_CHANGED
+ * 区间改变事件，与EVT_VALUE1_XXX/EVT_VALUE2_XXX同时分发，携带两个值。
+ */
+#define EVT_RANGE_CHANGED (EVT_USER_START + 7)
+
+/* range_slider_range_event_t的dragger，表示两个滑块同时改变 */
+#define RANGE_SLIDER_DRAGGER_BOTH 2
+
+/**
+ * @enum range_slider_phase_t
+ * @prefix RANGE_SLIDER_PHASE_
+ * 值改变的阶段。
+ */
+typedef enum _range_slider_phase_t {
+  /**
+   * @const RANGE_SLIDER_PHASE_WILL_CHANGE
+   * 即将改变。
+   */
+  RANGE_SLIDER_PHASE_WILL_CHANGE = 0,
+  /**
+   * @const RANGE_SLIDER_PHASE_CHANGING
+   * 正在改变(拖动中)。
+   */
+  RANGE_SLIDER_PHASE_CHANGING,
+  /**
+   * @const RANGE_SLIDER_PHASE_CHANGED
+   * 改变完成。
+   */
+  RANGE_SLIDER_PHASE_CHANGED
+} range_slider_phase_t;
+
+/**
+ * @class range_slider_range_event_t
+ * @parent event_t
+ * @annotation ["scriptable"]
+ * 区间改变事件。
+ */
+typedef struct _range_slider_range_event_t {
+  event_t e;
+  /**
+   * @property {uint32_t} dragger
+   * @annotation ["readable", "scriptable"]
+   * 改变的滑块，0表示dragger1，1表示dragger2，
+   * RANGE_SLIDER_DRAGGER_BOTH表示两个滑块同时改变(两个手指在同一帧内同时移动了两个滑块，
+   * 或者通过range_slider_set_range设置)，此时old_value/new_value无意义。
+   */
+  uint32_t dragger;
+  /**
+   * @property {range_slider_phase_t} phase
+   * @annotation ["readable", "scriptable"]
+   * 改变的阶段。
+   */
+  range_slider_phase_t phase;
+  /**
+   * @property {double} old_value
+   * @annotation ["readable", "scriptable"]
+   * 该滑块的旧值(拖动结束时为拖动开始时的值)。
+   */
+  double old_value;
+  /**
+   * @property {double} new_value
+   * @annotation ["readable", "scriptable"]
+   * 该滑块的新值。
+   */
+  double new_value;
+  /**
+   * @property {double} value1
+   * @annotation ["readable", "scriptable"]
+   * 分发时的value1。
+   */
+  double value1;
+  /**
+   * @property {double} value2
+   * @annotation ["readable", "scriptable"]
+   * 分发时的value2。
+   */
+  double value2;
+} range_slider_range_event_t;
+
+/**
+ * @method range_slider_range_event_cast
+ * 把event对象转range_slider_range_event_t对象。
+ * @annotation ["cast", "scriptable"]
+ * @param {event_t*} event event对象。
+ *
+ * @return {range_slider_range_event_t*} event对象。
+ */
+range_slider_range_event_t* range_slider_range_event_cast(event_t* event);
+
 
 #define RANGE_SLIDER(widget) ((range_slider_t*)(range_slider_cast(WIDGET(widget))))
 #define RANGE_SLIDER_PROP_VALUE1 "value1"
@@ -293,6 +665,16 @@ typedef struct _range_slider_t {
 #define RANGE_SLIDER_PROP_VIEW_WIDTH_RATIO "range_slider_view_width_ratio"
 #define RANGE_SLIDER_PROP_VIEW_HEIGHT_RATIO "range_slider_view_height_ratio"
 #define RANGE_SLIDER_PROP_VALUE_MIN_SHOW_ONE_POINT "value_min_show_one_point"
+#define RANGE_SLIDER_PROP_COUNT_LABEL_VISIBLE "count_label_visible"
+#define RANGE_SLIDER_PROP_COUNT_IN_RANGE "count_in_range"
+#define RANGE_SLIDER_PROP_SUM_IN_RANGE "sum_in_range"
+#define RANGE_SLIDER_PROP_MEAN_IN_RANGE "mean_in_range"
+#define RANGE_SLIDER_PROP_FOLLOW "follow"
+#define RANGE_SLIDER_PROP_VIEW_START "view_start"
+#define RANGE_SLIDER_PROP_VIEW_SPAN "view_span"
+#define RANGE_SLIDER_PROP_OVERVIEW_HEIGHT "overview_height"
+/* 只写，以"name=value;name=value"的形式一次设置多个属性，如"min=0;max=1000;value1=10;value2=90" */
+#define RANGE_SLIDER_PROP_CONFIG "config"
 
 #define RANGE_SLIDER_SUB_WIDGET_VIEW "range_slider_view"
 #define RANGE_SLIDER_SUB_WIDGET_DRAGGER1 "dragger1"
@@ -332,6 +714,255 @@ widget_t* range_slider_create(widget_t* parent, xy_t x, xy_t y, wh_t w, wh_t h);
  */
 widget_t* range_slider_cast(widget_t* widget);
 
+/**
+ * @method range_slider_get_config
+ * 获取全部配置。
+ * > 返回的样式名指向控件内部，在控件销毁或样式改变前有效。
+ * @annotation ["scriptable"]
+ * @param {widget_t*} widget range_slider对象。
+ * @param {range_slider_config_t*} config 返回配置。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_get_config(widget_t* widget, range_slider_config_t* config);
+
+/**
+ * @method range_slider_rebind
+ * 就地重新配置控件(范围、值、样式和可见性)，用于在虚拟列表中复用实例。
+ * 不分发值改变事件，不重复注册事件，正在进行的拖动和滑块选中状态会被取消，关联的数据集保持不变。
+ * @annotation ["scriptable"]
+ * @param {widget_t*} widget range_slider对象。
+ * @param {const range_slider_config_t*} config 配置。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_rebind(widget_t* widget, const range_slider_config_t* config);
+
+/**
+ * @method range_slider_set_range
+ * 同时设置两个值：只钳位取整一次、只更新一次统计、只刷新一次。
+ * 不分发EVT_VALUE1_XXX/EVT_VALUE2_XXX，notify为TRUE时分发一次EVT_RANGE_CHANGED
+ * (dragger为RANGE_SLIDER_DRAGGER_BOTH，阶段为RANGE_SLIDER_PHASE_CHANGED)。
+ * @annotation ["scriptable"]
+ * @param {widget_t*} widget range_slider对象。
+ * @param {double} value1 值1。
+ * @param {double} value2 值2。
+ * @param {bool_t} notify 是否分发事件，为FALSE时可在稍后调用range_slider_notify_range分发。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_set_range(widget_t* widget, double value1, double value2, bool_t notify);
+
+/**
+ * @method range_slider_notify_range
+ * 以当前的两个值分发一次EVT_RANGE_CHANGED(dragger为RANGE_SLIDER_DRAGGER_BOTH)。
+ * @annotation ["scriptable"]
+ * @param {widget_t*} widget range_slider对象。
+ * @param {range_slider_phase_t} phase 阶段。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_notify_range(widget_t* widget, range_slider_phase_t phase);
+
+/**
+ * @method range_slider_set_bounds
+ * 同时设置min和max：就地钳位两个值并按step或允许值取整，只更新范围label和滑轨，不重新布局。
+ * 值因此改变时分发一次EVT_RANGE_CHANGED(dragger为RANGE_SLIDER_DRAGGER_BOTH)。
+ * 跟随模式下只记录下来，在下一次idle中应用(同一帧内多次设置只应用最后一次)。
+ * min大于max时(如先设min再设max的中间状态)也先记下，到下一次idle时仍然颠倒则直接丢弃，
+ * 不修改控件，也不报错，此时返回值仍为RET_OK。
+ * @annotation ["scriptable"]
+ * @param {widget_t*} widget range_slider对象。
+ * @param {double} min 最小值。
+ * @param {double} max 最大值。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_set_bounds(widget_t* widget, double min, double max);
+
+/**
+ * @method range_slider_set_viewport
+ * 设置主滑轨显示的子区间(缩放)，用于在很大的范围(如0~1e12)上精细选择。
+ * 子区间会被限制在[min, max]之内，span不小于step，覆盖整个范围时取消缩放。
+ * 只刷新滑轨所在的view，不重新布局，不改变值。
+ * 也可以按住ctrl用滚轮缩放、按住shift用滚轮平移，或在滑块获得焦点时用+/-缩放、PageUp/PageDown平移。
+ * @annotation ["scriptable"]
+ * @param {widget_t*} widget range_slider对象。
+ * @param {double} start 子区间的起点。
+ * @param {double} span 子区间的长度，为0时取消缩放。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_set_viewport(widget_t* widget, double start, double span);
+
+/**
+ * @method range_slider_zoom
+ * 以anchor为中心缩放主滑轨(anchor在屏幕上的位置保持不变)。
+ * @annotation ["scriptable"]
+ * @param {widget_t*} widget range_slider对象。
+ * @param {double} factor 放大倍数，大于1为放大，小于1为缩小。
+ * @param {double} anchor 缩放中心的值。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_zoom(widget_t* widget, double factor, double anchor);
+
+/**
+ * @method range_slider_configure
+ * 一次性设置全部配置：只钳位一次、只重新布局一次，不分发值改变事件。
+ * 在加载过程中调用时只保存配置，等加载完成后再应用。
+ * @annotation ["scriptable"]
+ * @param {widget_t*} widget range_slider对象。
+ * @param {const range_slider_config_t*} config 配置。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_configure(widget_t* widget, const range_slider_config_t* config);
+
+/**
+ * @method range_slider_reset
+ * 把控件恢复到刚创建时的配置(样式名保持不变)，并解除关联的数据集，用于回收实例。
+ * 与range_slider_rebind一样，不分发值改变事件。
+ * @annotation ["scriptable"]
+ * @param {widget_t*} widget range_slider对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_reset(widget_t* widget);
+
+/**
+ * @method range_slider_save_state
+ * 把运行时的状态(value1/value2/min/max/step、缩放的子区间、follow和no_use_second_dragger)
+ * 以紧凑的二进制格式(本机字节序)写入wb，用于保存预设。样式和布局相关的属性不保存。
+ * @param {widget_t*} widget range_slider对象。
+ * @param {wbuffer_t*} wb 写缓冲区。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_save_state(widget_t* widget, wbuffer_t* wb);
+
+/**
+ * @method range_slider_load_state
+ * 从rb中恢复range_slider_save_state保存的状态：直接设置各个字段，不经过属性查找，
+ * 数据不合法时不做任何修改。值改变时分发一次EVT_RANGE_CHANGED(dragger为RANGE_SLIDER_DRAGGER_BOTH)。
+ * @param {widget_t*} widget range_slider对象。
+ * @param {rbuffer_t*} rb 读缓冲区。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_load_state(widget_t* widget, rbuffer_t* rb);
+
+/**
+ * @method range_slider_save_states
+ * 遍历root及其全部子孙控件，把其中每个range_slider的状态依次写入wb。
+ * @param {widget_t*} root 根控件(通常为窗口)。
+ * @param {wbuffer_t*} wb 写缓冲区。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_save_states(widget_t* root, wbuffer_t* wb);
+
+/**
+ * @method range_slider_load_states
+ * 按遍历顺序把range_slider_save_states保存的状态依次恢复到root下的各个range_slider，
+ * 各个控件不单独刷新，全部恢复后只刷新一次root。完成后rb的读取位置在全部记录之后。
+ * 记录个数与控件个数不同时，前面对得上的控件照常恢复，多出的记录或控件被忽略，返回RET_NOT_FOUND。
+ * 先检查全部记录，数据被截断或不合法时不修改任何控件，rb的读取位置也保持不变。
+ * @param {widget_t*} root 根控件(通常为窗口)。
+ * @param {rbuffer_t*} rb 读缓冲区。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，RET_NOT_FOUND表示个数不一致，否则表示失败。
+ */
+ret_t range_slider_load_states(widget_t* root, rbuffer_t* rb);
+
+/**
+ * @method range_slider_set_dataset
+ * 关联升序排列的数据集，之后每次值改变时用二分查找更新count_in_range/sum_in_range/mean_in_range。
+ * > 数组不会被拷贝，在解除关联(data传NULL)或控件销毁之前，调用者须保证数组有效且不被修改。
+ * @annotation ["scriptable"]
+ * @param {widget_t*} widget range_slider对象。
+ * @param {const double*} data 升序排列的数组，为NULL时解除关联。
+ * @param {const double*} prefix_sum 前缀和(nr+1个元素，prefix_sum[i]为前i个元素之和)，可为NULL，为NULL时不统计总和与平均值。
+ * @param {uint32_t} nr 数组元素个数。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_set_dataset(widget_t* widget, const double* data, const double* prefix_sum,
+                               uint32_t nr);
+
+/**
+ * @method range_slider_set_histogram
+ * 关联等宽分桶的前缀和直方图，第i个桶覆盖[start + i * bin_width, start + (i + 1) * bin_width)。
+ * 统计按桶进行，被区间部分覆盖的桶按整桶计入。
+ * > 数组不会被拷贝，在解除关联(prefix_count传NULL)或控件销毁之前，调用者须保证数组有效且不被修改。
+ * @annotation ["scriptable"]
+ * @param {widget_t*} widget range_slider对象。
+ * @param {double} start 第一个桶的起点。
+ * @param {double} bin_width 桶宽。
+ * @param {const double*} prefix_count 数据个数的前缀和(bins+1个元素)，为NULL时解除关联。
+ * @param {const double*} prefix_sum 数据总和的前缀和(bins+1个元素)，可为NULL。
+ * @param {uint32_t} bins 桶数。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_set_histogram(widget_t* widget, double start, double bin_width,
+                                 const double* prefix_count, const double* prefix_sum,
+                                 uint32_t bins);
+
+/**
+ * @method range_slider_set_allowed_values
+ * 关联允许的取值(如非均匀的截止频率、E系列电阻值)，之后值只能取其中的元素：
+ * 设置值时用二分查找取最近的允许值，键盘增减和防碰撞取相邻的允许值，不再使用step。
+ * 关联时当前值直接取整到最近的允许值，不分发值改变事件。
+ * > 数组不会被拷贝(多个控件可以共享同一个数组)，在解除关联(values传NULL)或控件销毁之前，调用者须保证数组有效且不被修改。
+ * @annotation ["scriptable"]
+ * @param {widget_t*} widget range_slider对象。
+ * @param {const double*} values 升序排列且无重复的数组，为NULL时解除关联。
+ * @param {uint32_t} nr 数组元素个数。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_set_allowed_values(widget_t* widget, const double* values, uint32_t nr);
+
+/**
+ * @method range_slider_set_index_labels
+ * 设置索引模式，用于在有序的类别(日期、样本编号、通道名等)上选择区间。
+ * min/max/value都是类别的索引(step至少为1，值取整)，label文本由回调按需生成，
+ * 只为实际显示的索引调用，并缓存最近用过的几个，类别再多也不增加每帧的开销。
+ * > ctx在解除(label传NULL)、range_slider_reset或控件销毁之前须保持有效。
+ * @param {widget_t*} widget range_slider对象。
+ * @param {range_slider_index_label_t} label 生成label文本的回调，为NULL时恢复显示数值。
+ * @param {void*} ctx 回调的上下文。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_set_index_labels(widget_t* widget, range_slider_index_label_t label,
+                                    void* ctx);
+
+/**
+ * @method range_slider_set_snapshot
+ * 设置快照：之后每次值或范围改变时把value1/value2/min/max写入快照，
+ * 工作线程通过range_slider_snapshot_read无锁地读取，不必访问控件或向GUI线程发送请求。
+ * 设置时立即写入一次当前的区间。
+ * > 快照的内存由调用者提供，在解除(snapshot传NULL)、range_slider_reset或控件销毁之前须保持有效。
+ * @param {widget_t*} widget range_slider对象。
+ * @param {range_slider_snapshot_t*} snapshot 快照，为NULL时不再发布。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_set_snapshot(widget_t* widget, range_slider_snapshot_t* snapshot);
+
+/**
+ * @method range_slider_invalidate_style_cache
+ * 使缓存的样式失效，下次绘制时重新解析。
+ * 状态、主题、style和dragger_style改变时会自动失效，通过widget_set_style修改内联样式后需手动调用。
+ * @annotation ["scriptable"]
+ * @param {widget_t*} widget range_slider对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_invalidate_style_cache(widget_t* widget);
+
 
 
 
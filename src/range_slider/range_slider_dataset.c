@@ -0,0 +1,115 @@
+﻿/**
+ * File:   range_slider_dataset.c
+ * Author:
+ * Brief:  range_slider关联的有序数据集(用于统计区间内的数据个数)
+ *
+ * Copyright (c) 2024 - 2024
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2026-10-19  created
+ *
+ */
+
+#include "tkc/utils.h"
+#include "range_slider_dataset.h"
+
+uint32_t range_slider_dataset_lower_bound(const double* data, uint32_t nr, double value) {
+  uint32_t lo = 0;
+  uint32_t hi = nr;
+  return_value_if_fail(data != NULL, 0);
+
+  while (lo < hi) {
+    uint32_t mid = lo + ((hi - lo) >> 1);
+    if (data[mid] < value) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  return lo;
+}
+
+uint32_t range_slider_dataset_upper_bound(const double* data, uint32_t nr, double value) {
+  uint32_t lo = 0;
+  uint32_t hi = nr;
+  return_value_if_fail(data != NULL, 0);
+
+  while (lo < hi) {
+    uint32_t mid = lo + ((hi - lo) >> 1);
+    if (data[mid] <= value) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  return lo;
+}
+
+bool_t range_slider_dataset_is_empty(const range_slider_dataset_t* ds) {
+  return ds == NULL || ds->nr == 0 || (ds->data == NULL && ds->prefix_count == NULL);
+}
+
+static uint32_t range_slider_dataset_bin_of(const range_slider_dataset_t* ds, double value) {
+  double bin = (value - ds->start) / ds->bin_width;
+
+  if (bin <= 0) {
+    return 0;
+  } else if (bin >= ds->nr) {
+    return ds->nr;
+  }
+
+  return (uint32_t)bin;
+}
+
+ret_t range_slider_dataset_query(const range_slider_dataset_t* ds, double lo, double hi,
+                                 uint32_t* count, double* sum) {
+  uint32_t first = 0;
+  uint32_t last = 0;
+  return_value_if_fail(count != NULL && sum != NULL, RET_BAD_PARAMS);
+
+  *count = 0;
+  *sum = 0;
+  if (range_slider_dataset_is_empty(ds) || hi < lo) {
+    return RET_OK;
+  }
+
+  if (ds->prefix_count != NULL) {
+    return_value_if_fail(ds->bin_width > 0, RET_BAD_PARAMS);
+    if (hi < ds->start || lo >= ds->start + ds->nr * ds->bin_width) {
+      /* 区间整个在直方图之外，不能按夹紧后的首尾桶计数 */
+      return RET_OK;
+    }
+    /* 直方图按桶统计，部分覆盖的桶按整桶计入 */
+    first = range_slider_dataset_bin_of(ds, lo);
+    last = range_slider_dataset_bin_of(ds, hi);
+    last = tk_min(last + 1, ds->nr);
+    if (last > first) {
+      *count = (uint32_t)(ds->prefix_count[last] - ds->prefix_count[first]);
+      if (ds->prefix_sum != NULL) {
+        *sum = ds->prefix_sum[last] - ds->prefix_sum[first];
+      }
+    }
+  } else {
+    first = range_slider_dataset_lower_bound(ds->data, ds->nr, lo);
+    last = range_slider_dataset_upper_bound(ds->data, ds->nr, hi);
+    if (last > first) {
+      *count = last - first;
+      if (ds->prefix_sum != NULL) {
+        *sum = ds->prefix_sum[last] - ds->prefix_sum[first];
+      }
+    }
+  }
+
+  return RET_OK;
+}
@@ -0,0 +1,99 @@
+﻿/**
+ * File:   range_slider_dataset.h
+ * Author:
+ * Brief:  range_slider关联的有序数据集(用于统计区间内的数据个数)
+ *
+ * Copyright (c) 2024 - 2024
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2026-10-19  created
+ *
+ */
+
+#ifndef TK_RANGE_SLIDER_DATASET_H
+#define TK_RANGE_SLIDER_DATASET_H
+
+#include "tkc/types_def.h"
+
+BEGIN_C_DECLS
+
+/**
+ * @class range_slider_dataset_t
+ * range_slider关联的数据集，支持两种形式：
+ *
+ * * 升序排列的数组(可选附带前缀和)，查询为两次二分查找，复杂度O(log n)。
+ * * 等宽分桶的前缀和直方图，查询复杂度O(1)，精度为一个桶宽。
+ *
+ * 数据集只引用调用者的数组，不做拷贝，数组的生命周期由调用者保证。
+ */
+typedef struct _range_slider_dataset_t {
+  /* 升序数组 */
+  const double* data;
+  /* 前缀和，可为NULL，有nr+1个元素，prefix_sum[i]为前i个元素之和 */
+  const double* prefix_sum;
+  /* 数组元素个数或直方图的桶数 */
+  uint32_t nr;
+
+  /* 直方图，prefix_count[i]为前i个桶的数据个数之和，有nr+1个元素 */
+  const double* prefix_count;
+  double start;
+  double bin_width;
+} range_slider_dataset_t;
+
+/**
+ * @method range_slider_dataset_lower_bound
+ * 查找第一个不小于value的元素的位置。
+ * @param {const double*} data 升序数组。
+ * @param {uint32_t} nr 元素个数。
+ * @param {double} value 值。
+ *
+ * @return {uint32_t} 返回位置，全部小于value时返回nr。
+ */
+uint32_t range_slider_dataset_lower_bound(const double* data, uint32_t nr, double value);
+
+/**
+ * @method range_slider_dataset_upper_bound
+ * 查找第一个大于value的元素的位置。
+ * @param {const double*} data 升序数组。
+ * @param {uint32_t} nr 元素个数。
+ * @param {double} value 值。
+ *
+ * @return {uint32_t} 返回位置，全部不大于value时返回nr。
+ */
+uint32_t range_slider_dataset_upper_bound(const double* data, uint32_t nr, double value);
+
+/**
+ * @method range_slider_dataset_is_empty
+ * 数据集是否为空。
+ * @param {const range_slider_dataset_t*} ds 数据集。
+ *
+ * @return {bool_t} 返回TRUE表示为空。
+ */
+bool_t range_slider_dataset_is_empty(const range_slider_dataset_t* ds);
+
+/**
+ * @method range_slider_dataset_query
+ * 统计[lo, hi]区间内的数据个数和总和。
+ * @param {const range_slider_dataset_t*} ds 数据集。
+ * @param {double} lo 区间下限。
+ * @param {double} hi 区间上限。
+ * @param {uint32_t*} count 返回数据个数。
+ * @param {double*} sum 返回数据总和，没有前缀和时返回0。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_dataset_query(const range_slider_dataset_t* ds, double lo, double hi,
+                                 uint32_t* count, double* sum);
+
+END_C_DECLS
+
+#endif /*TK_RANGE_SLIDER_DATASET_H*/
@@ -0,0 +1,368 @@
+﻿/**
+ * File:   range_slider_group.c
+ * Author:
+ * Brief:  相互约束的一组range_slider
+ *
+ * Copyright (c) 2024 - 2024
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2026-10-19  created
+ *
+ */
+
+#include "tkc/mem.h"
+#include "tkc/utils.h"
+#include "range_slider_group.h"
+
+#define V1(group, i) ((group)->values[(i) * 2])
+#define V2(group, i) ((group)->values[(i) * 2 + 1])
+/* 通知过程中成员被事件处理函数改变时最多再求解的次数 */
+#define RANGE_SLIDER_GROUP_MAX_PASSES 4
+#define MIN_OF(group, i) (RANGE_SLIDER((group)->members[i])->min)
+#define MAX_OF(group, i) (RANGE_SLIDER((group)->members[i])->max)
+
+static ret_t range_slider_group_on_range_changed(void* ctx, event_t* e);
+static ret_t range_slider_group_on_member_destroy(void* ctx, event_t* e);
+
+range_slider_group_t* range_slider_group_create(range_slider_group_rule_t rule, uint32_t capacity) {
+  range_slider_group_t* group = NULL;
+  return_value_if_fail(capacity > 0, NULL);
+
+  group = TKMEM_ZALLOC(range_slider_group_t);
+  return_value_if_fail(group != NULL, NULL);
+
+  group->rule = rule;
+  group->capacity = capacity;
+  group->deferred = -1;
+  group->members = TKMEM_ZALLOCN(widget_t*, capacity);
+  group->values = TKMEM_ZALLOCN(double, capacity * 2);
+  group->changed = TKMEM_ZALLOCN(bool_t, capacity);
+  if (group->members == NULL || group->values == NULL || group->changed == NULL) {
+    range_slider_group_destroy(group);
+    return NULL;
+  }
+
+  return group;
+}
+
+ret_t range_slider_group_set_gap(range_slider_group_t* group, double gap) {
+  return_value_if_fail(group != NULL && gap >= 0, RET_BAD_PARAMS);
+  group->gap = gap;
+  return RET_OK;
+}
+
+ret_t range_slider_group_set_total(range_slider_group_t* group, double total) {
+  return_value_if_fail(group != NULL && total >= 0, RET_BAD_PARAMS);
+  group->total = total;
+  return RET_OK;
+}
+
+static int32_t range_slider_group_index_of(range_slider_group_t* group, widget_t* widget) {
+  uint32_t i = 0;
+
+  for (i = 0; i < group->nr; i++) {
+    if (group->members[i] == widget) {
+      return i;
+    }
+  }
+
+  return -1;
+}
+
+ret_t range_slider_group_add(range_slider_group_t* group, widget_t* widget) {
+  return_value_if_fail(group != NULL && RANGE_SLIDER(widget) != NULL, RET_BAD_PARAMS);
+  return_value_if_fail(!group->resolving, RET_BUSY);
+  return_value_if_fail(group->nr < group->capacity, RET_FAIL);
+  return_value_if_fail(range_slider_group_index_of(group, widget) < 0, RET_FOUND);
+
+  group->members[group->nr++] = widget;
+  widget_on(widget, EVT_RANGE_CHANGED, range_slider_group_on_range_changed, group);
+  widget_on(widget, EVT_DESTROY, range_slider_group_on_member_destroy, group);
+
+  return RET_OK;
+}
+
+ret_t range_slider_group_remove(range_slider_group_t* group, widget_t* widget) {
+  int32_t index = 0;
+  return_value_if_fail(group != NULL && widget != NULL, RET_BAD_PARAMS);
+  return_value_if_fail(!group->resolving, RET_BUSY);
+
+  index = range_slider_group_index_of(group, widget);
+  return_value_if_fail(index >= 0, RET_NOT_FOUND);
+
+  widget_off_by_ctx(widget, group);
+  memmove(group->members + index, group->members + index + 1,
+          (group->nr - index - 1) * sizeof(widget_t*));
+  group->nr--;
+
+  return RET_OK;
+}
+
+/* 从src向右推开重叠的成员，碰到边界推不动时再从右向左压回来(可能压到src) */
+static ret_t range_slider_group_no_overlap(range_slider_group_t* group, uint32_t src) {
+  int32_t i = 0;
+  int32_t nr = group->nr;
+  double gap = group->gap;
+
+  for (i = src + 1; i < nr; i++) {
+    double limit = V2(group, i - 1) + gap;
+    if (V1(group, i) < limit) {
+      double width = V2(group, i) - V1(group, i);
+      V1(group, i) = tk_min(limit, MAX_OF(group, i));
+      V2(group, i) = tk_min(limit + width, MAX_OF(group, i));
+    }
+  }
+  for (i = nr - 1; i > (int32_t)src; i--) {
+    double limit = V1(group, i) - gap;
+    if (V2(group, i - 1) > limit) {
+      V2(group, i - 1) = limit;
+      V1(group, i - 1) = tk_min(V1(group, i - 1), limit);
+    }
+  }
+
+  /* 向左同理 */
+  for (i = src - 1; i >= 0; i--) {
+    double limit = V1(group, i + 1) - gap;
+    if (V2(group, i) > limit) {
+      double width = V2(group, i) - V1(group, i);
+      V2(group, i) = tk_max(limit, MIN_OF(group, i));
+      V1(group, i) = tk_max(limit - width, MIN_OF(group, i));
+    }
+  }
+  for (i = 0; i < (int32_t)src; i++) {
+    double limit = V2(group, i) + gap;
+    if (V1(group, i + 1) < limit) {
+      V1(group, i + 1) = limit;
+      V2(group, i + 1) = tk_max(V2(group, i + 1), limit);
+    }
+  }
+
+  return RET_OK;
+}
+
+/* 相邻的边界保持相隔gap，边界推到另一个边界之外时一起推动 */
+static ret_t range_slider_group_fixed_gap(range_slider_group_t* group, uint32_t src) {
+  int32_t i = 0;
+  int32_t nr = group->nr;
+  double gap = group->gap;
+
+  for (i = src + 1; i < nr; i++) {
+    V1(group, i) = tk_clamp(V2(group, i - 1) + gap, MIN_OF(group, i), MAX_OF(group, i));
+    V2(group, i) = tk_max(V2(group, i), V1(group, i));
+  }
+  for (i = nr - 1; i > (int32_t)src; i--) {
+    V2(group, i - 1) = V1(group, i) - gap;
+    V1(group, i - 1) = tk_min(V1(group, i - 1), V2(group, i - 1));
+  }
+
+  for (i = src - 1; i >= 0; i--) {
+    V2(group, i) = tk_clamp(V1(group, i + 1) - gap, MIN_OF(group, i), MAX_OF(group, i));
+    V1(group, i) = tk_min(V1(group, i), V2(group, i));
+  }
+  for (i = 0; i < (int32_t)src; i++) {
+    V1(group, i + 1) = V2(group, i) + gap;
+    V2(group, i + 1) = tk_max(V2(group, i + 1), V1(group, i + 1));
+  }
+
+  return RET_OK;
+}
+
+/* src的宽度不变，其余成员按原宽度的比例分摊剩下的宽度(只移动value2)，分摊不下时再压缩src */
+static ret_t range_slider_group_shared_total(range_slider_group_t* group, uint32_t src) {
+  uint32_t i = 0;
+  uint32_t others = group->nr - 1;
+  double sum = 0;
+  double rest = 0;
+  double src_width = tk_clamp(V2(group, src) - V1(group, src), 0, group->total);
+
+  if (others == 0) {
+    return RET_OK;
+  }
+
+  for (i = 0; i < group->nr; i++) {
+    if (i != src) {
+      sum += V2(group, i) - V1(group, i);
+    }
+  }
+
+  rest = group->total - src_width;
+  for (i = 0; i < group->nr; i++) {
+    if (i != src) {
+      double width = sum > 0 ? (V2(group, i) - V1(group, i)) * rest / sum : rest / others;
+      V2(group, i) = tk_min(V1(group, i) + width, MAX_OF(group, i));
+    }
+  }
+
+  sum = 0;
+  for (i = 0; i < group->nr; i++) {
+    if (i != src) {
+      sum += V2(group, i) - V1(group, i);
+    }
+  }
+  V2(group, src) = tk_min(V1(group, src) + (group->total - sum), MAX_OF(group, src));
+
+  return RET_OK;
+}
+
+/* 一次算出全部成员的新值，全部写入之后再逐个通知 */
+static ret_t range_slider_group_resolve_once(range_slider_group_t* group, uint32_t src,
+                                             range_slider_phase_t phase) {
+  uint32_t i = 0;
+
+  if (src >= group->nr) {
+    return RET_OK;
+  }
+  group->resolving = TRUE;
+
+  for (i = 0; i < group->nr; i++) {
+    range_slider_t* range_slider = RANGE_SLIDER(group->members[i]);
+    V1(group, i) = range_slider->value1;
+    V2(group, i) = range_slider->value2;
+  }
+
+  switch (group->rule) {
+    case RANGE_SLIDER_GROUP_NO_OVERLAP: {
+      range_slider_group_no_overlap(group, src);
+      break;
+    }
+    case RANGE_SLIDER_GROUP_FIXED_GAP: {
+      range_slider_group_fixed_gap(group, src);
+      break;
+    }
+    case RANGE_SLIDER_GROUP_SHARED_TOTAL: {
+      range_slider_group_shared_total(group, src);
+      break;
+    }
+    default:
+      break;
+  }
+
+  for (i = 0; i < group->nr; i++) {
+    widget_t* member = group->members[i];
+    range_slider_t* range_slider = RANGE_SLIDER(member);
+    double old_value1 = range_slider->value1;
+    double old_value2 = range_slider->value2;
+
+    range_slider_set_range(member, V1(group, i), V2(group, i), FALSE);
+    group->changed[i] = range_slider->value1 != old_value1 || range_slider->value2 != old_value2;
+    /* 记下取整后实际写入的值，用来识别通知过程中的改变 */
+    V1(group, i) = range_slider->value1;
+    V2(group, i) = range_slider->value2;
+  }
+
+  for (i = 0; i < group->nr; i++) {
+    if (group->changed[i]) {
+      range_slider_notify_range(group->members[i], phase);
+    }
+  }
+
+  group->resolving = FALSE;
+
+  return RET_OK;
+}
+
+/* 通知过程中事件处理函数改变了成员时，以最后改变的成员为源再求解，次数有限 */
+static ret_t range_slider_group_resolve_from(range_slider_group_t* group, uint32_t src,
+                                             range_slider_phase_t phase) {
+  uint32_t pass = 0;
+
+  if (group->resolving) {
+    return RET_OK;
+  }
+
+  group->deferred = src;
+  for (pass = 0; pass < RANGE_SLIDER_GROUP_MAX_PASSES && group->deferred >= 0; pass++) {
+    src = (uint32_t)(group->deferred);
+    group->deferred = -1;
+    range_slider_group_resolve_once(group, src, phase);
+  }
+  if (group->deferred >= 0) {
+    log_debug("range_slider_group: member %d still changing, give up\n", group->deferred);
+    group->deferred = -1;
+  }
+
+  return RET_OK;
+}
+
+ret_t range_slider_group_resolve(range_slider_group_t* group, widget_t* widget) {
+  int32_t index = 0;
+  return_value_if_fail(group != NULL, RET_BAD_PARAMS);
+
+  if (group->nr == 0) {
+    return RET_OK;
+  }
+
+  index = widget != NULL ? range_slider_group_index_of(group, widget) : 0;
+  return_value_if_fail(index >= 0, RET_NOT_FOUND);
+
+  return range_slider_group_resolve_from(group, index, RANGE_SLIDER_PHASE_CHANGED);
+}
+
+static ret_t range_slider_group_on_range_changed(void* ctx, event_t* e) {
+  int32_t index = 0;
+  range_slider_group_t* group = (range_slider_group_t*)ctx;
+  range_slider_range_event_t* evt = range_slider_range_event_cast(e);
+  return_value_if_fail(group != NULL && evt != NULL, RET_OK);
+
+  if (evt->phase == RANGE_SLIDER_PHASE_WILL_CHANGE) {
+    return RET_OK;
+  }
+
+  index = range_slider_group_index_of(group, WIDGET(e->target));
+  if (index < 0) {
+    return RET_OK;
+  }
+
+  if (group->resolving) {
+    /* 由约束引起的改变不再触发求解，事件处理函数在通知过程中做的改变记下来，通知完成后再求解 */
+    range_slider_t* range_slider = RANGE_SLIDER(WIDGET(e->target));
+    if (range_slider->value1 != V1(group, index) || range_slider->value2 != V2(group, index)) {
+      group->deferred = index;
+    }
+    return RET_OK;
+  }
+
+  range_slider_group_resolve_from(group, index, evt->phase);
+
+  return RET_OK;
+}
+
+static ret_t range_slider_group_on_member_destroy(void* ctx, event_t* e) {
+  int32_t index = 0;
+  range_slider_group_t* group = (range_slider_group_t*)ctx;
+  return_value_if_fail(group != NULL, RET_REMOVE);
+
+  index = range_slider_group_index_of(group, WIDGET(e->target));
+  if (index >= 0) {
+    memmove(group->members + index, group->members + index + 1,
+            (group->nr - index - 1) * sizeof(widget_t*));
+    group->nr--;
+  }
+
+  return RET_REMOVE;
+}
+
+ret_t range_slider_group_destroy(range_slider_group_t* group) {
+  uint32_t i = 0;
+  return_value_if_fail(group != NULL, RET_BAD_PARAMS);
+
+  for (i = 0; i < group->nr; i++) {
+    widget_off_by_ctx(group->members[i], group);
+  }
+
+  TKMEM_FREE(group->members);
+  TKMEM_FREE(group->values);
+  TKMEM_FREE(group->changed);
+  TKMEM_FREE(group);
+
+  return RET_OK;
+}
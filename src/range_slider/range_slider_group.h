@@ -0,0 +1,161 @@
+﻿/**
+ * File:   range_slider_group.h
+ * Author:
+ * Brief:  相互约束的一组range_slider
+ *
+ * Copyright (c) 2024 - 2024
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2026-10-19  created
+ *
+ */
+
+#ifndef TK_RANGE_SLIDER_GROUP_H
+#define TK_RANGE_SLIDER_GROUP_H
+
+#include "range_slider.h"
+
+BEGIN_C_DECLS
+
+/**
+ * @enum range_slider_group_rule_t
+ * @prefix RANGE_SLIDER_GROUP_
+ * 组内成员之间的约束，成员按加入的顺序从左到右排列。
+ */
+typedef enum _range_slider_group_rule_t {
+  /**
+   * @const RANGE_SLIDER_GROUP_NO_OVERLAP
+   * 区间互不重叠，相邻区间至少相隔gap。重叠时推开相邻的成员(保持宽度，到边界时压缩)。
+   */
+  RANGE_SLIDER_GROUP_NO_OVERLAP = 0,
+  /**
+   * @const RANGE_SLIDER_GROUP_FIXED_GAP
+   * 相邻区间首尾相接且恰好相隔gap(如相邻的频段)，移动一个边界时相邻成员的边界随之移动。
+   */
+  RANGE_SLIDER_GROUP_FIXED_GAP,
+  /**
+   * @const RANGE_SLIDER_GROUP_SHARED_TOTAL
+   * 各区间的宽度(value2 - value1)之和保持为total，其它成员按原宽度的比例分摊变化。
+   */
+  RANGE_SLIDER_GROUP_SHARED_TOTAL
+} range_slider_group_rule_t;
+
+/**
+ * @class range_slider_group_t
+ * 相互约束的一组range_slider。
+ *
+ * 任一成员的值改变(EVT_RANGE_CHANGED)时，按约束一次性算出全部成员的新值，
+ * 先全部写入，再给每个改变了的成员分发一次EVT_RANGE_CHANGED(dragger为RANGE_SLIDER_DRAGGER_BOTH)，
+ * 每个成员只刷新一次。通知过程中成员再次改变(如在事件处理函数中设置其它成员)时不会重入，
+ * 而是在通知完成后以该成员为源再求解一次(最多重复几次，防止事件处理函数反复修改时死循环)。
+ *
+ * 由约束引起的改变不分发EVT_VALUE1_XXX/EVT_VALUE2_XXX，需要时请监听EVT_RANGE_CHANGED。
+ * 成员须使用两个滑块。成员销毁时自动从组中移除。
+ *
+ * ```c
+ * range_slider_group_t* group = range_slider_group_create(RANGE_SLIDER_GROUP_NO_OVERLAP, 3);
+ * range_slider_group_set_gap(group, 5);
+ * range_slider_group_add(group, band1);
+ * range_slider_group_add(group, band2);
+ * range_slider_group_add(group, band3);
+ * ```
+ */
+typedef struct _range_slider_group_t {
+  range_slider_group_rule_t rule;
+  double gap;
+  double total;
+  widget_t** members;
+  uint32_t nr;
+  uint32_t capacity;
+  /* 求解用的缓冲区，每个成员两个值，创建时一次分配 */
+  double* values;
+  bool_t* changed;
+  /* 正在求解，用于防止重入 */
+  bool_t resolving;
+  /* 通知过程中被事件处理函数改变的成员，通知完成后以它为源再求解，没有时为-1 */
+  int32_t deferred;
+} range_slider_group_t;
+
+/**
+ * @method range_slider_group_create
+ * 创建组。
+ * @annotation ["constructor"]
+ * @param {range_slider_group_rule_t} rule 约束。
+ * @param {uint32_t} capacity 最多的成员个数。
+ *
+ * @return {range_slider_group_t*} 返回组对象，失败返回NULL。
+ */
+range_slider_group_t* range_slider_group_create(range_slider_group_rule_t rule, uint32_t capacity);
+
+/**
+ * @method range_slider_group_set_gap
+ * 设置相邻区间的间距(用于RANGE_SLIDER_GROUP_NO_OVERLAP和RANGE_SLIDER_GROUP_FIXED_GAP)。
+ * @param {range_slider_group_t*} group 组对象。
+ * @param {double} gap 间距。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_group_set_gap(range_slider_group_t* group, double gap);
+
+/**
+ * @method range_slider_group_set_total
+ * 设置宽度之和(用于RANGE_SLIDER_GROUP_SHARED_TOTAL)。
+ * @param {range_slider_group_t*} group 组对象。
+ * @param {double} total 宽度之和。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_group_set_total(range_slider_group_t* group, double total);
+
+/**
+ * @method range_slider_group_add
+ * 加入成员，排在已有成员的右侧。加入时不求解，需要时调用range_slider_group_resolve。
+ * @param {range_slider_group_t*} group 组对象。
+ * @param {widget_t*} widget range_slider对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_group_add(range_slider_group_t* group, widget_t* widget);
+
+/**
+ * @method range_slider_group_remove
+ * 移除成员。
+ * @param {range_slider_group_t*} group 组对象。
+ * @param {widget_t*} widget range_slider对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_group_remove(range_slider_group_t* group, widget_t* widget);
+
+/**
+ * @method range_slider_group_resolve
+ * 以widget的当前值为准，按约束调整其它成员(如初始化或修改约束之后)。
+ * @param {range_slider_group_t*} group 组对象。
+ * @param {widget_t*} widget 作为基准的成员，为NULL时以第一个成员为准。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_group_resolve(range_slider_group_t* group, widget_t* widget);
+
+/**
+ * @method range_slider_group_destroy
+ * 销毁组(成员不会被销毁)。
+ * @annotation ["deconstructor"]
+ * @param {range_slider_group_t*} group 组对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_group_destroy(range_slider_group_t* group);
+
+END_C_DECLS
+
+#endif /*TK_RANGE_SLIDER_GROUP_H*/
@@ -0,0 +1,180 @@
+﻿/**
+ * File:   range_slider_pool.c
+ * Author:
+ * Brief:  range_slider预分配池(启动后创建和销毁不再使用堆)
+ *
+ * Copyright (c) 2024 - 2024
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2026-10-19  created
+ *
+ */
+
+#include "tkc/mem.h"
+#include "tkc/utils.h"
+#include "tkc/emitter.h"
+#include "range_slider_pool.h"
+
+range_slider_pool_t* range_slider_pool_create(uint32_t capacity) {
+  uint32_t i = 0;
+  range_slider_pool_t* pool = NULL;
+  return_value_if_fail(capacity > 0, NULL);
+
+  pool = TKMEM_ZALLOC(range_slider_pool_t);
+  return_value_if_fail(pool != NULL, NULL);
+
+  pool->sliders = TKMEM_ZALLOCN(widget_t*, capacity);
+  pool->free_list = TKMEM_ZALLOCN(widget_t*, capacity);
+  pool->in_use = TKMEM_ZALLOCN(bool_t, capacity);
+  goto_error_if_fail(pool->sliders != NULL && pool->free_list != NULL && pool->in_use != NULL);
+  pool->capacity = capacity;
+
+  for (i = 0; i < capacity; i++) {
+    widget_t* widget = range_slider_create(NULL, 0, 0, 0, 0);
+    goto_error_if_fail(widget != NULL);
+
+    /* 先标记为池中的控件，之后的子控件只隐藏不销毁 */
+    RANGE_SLIDER(widget)->pool = pool;
+    /* 缺省配置需要全部子控件，在这里一次创建好 */
+    range_slider_reset(widget);
+
+    pool->sliders[i] = widget;
+    pool->free_list[pool->free_nr++] = widget;
+  }
+
+  return pool;
+error:
+  range_slider_pool_destroy(pool);
+  return NULL;
+}
+
+static int32_t range_slider_pool_index_of(range_slider_pool_t* pool, widget_t* widget) {
+  uint32_t i = 0;
+
+  for (i = 0; i < pool->capacity; i++) {
+    if (pool->sliders[i] == widget) {
+      return (int32_t)i;
+    }
+  }
+
+  return -1;
+}
+
+/*
+ * 清除上一个使用者在控件上注册的事件处理函数，避免下一个使用者触发它们(ctx可能已释放)。
+ * 先分发EVT_DESTROY，让range_slider_group等把控件移除，控件自身没有在自己身上注册处理函数。
+ */
+static ret_t range_slider_pool_clear_listeners(widget_t* widget) {
+  if (widget->emitter != NULL) {
+    event_t e = event_init(EVT_DESTROY, widget);
+    emitter_dispatch(widget->emitter, &e);
+    emitter_destroy(widget->emitter);
+    widget->emitter = NULL;
+  }
+
+  return RET_OK;
+}
+
+uint32_t range_slider_pool_collect(range_slider_pool_t* pool) {
+  uint32_t i = 0;
+  uint32_t nr = 0;
+  return_value_if_fail(pool != NULL, 0);
+
+  for (i = 0; i < pool->capacity; i++) {
+    widget_t* widget = pool->sliders[i];
+    /* 只剩池持有的引用，说明已被调用者(或随父控件一起)销毁 */
+    if (pool->in_use[i] && widget->ref_count == 1) {
+      range_slider_reset(widget);
+      range_slider_pool_clear_listeners(widget);
+      pool->in_use[i] = FALSE;
+      pool->free_list[pool->free_nr++] = widget;
+      nr++;
+    }
+  }
+
+  return nr;
+}
+
+widget_t* range_slider_pool_acquire(range_slider_pool_t* pool, widget_t* parent, xy_t x, xy_t y,
+                                    wh_t w, wh_t h) {
+  widget_t* widget = NULL;
+  return_value_if_fail(pool != NULL, NULL);
+
+  if (pool->free_nr == 0 && range_slider_pool_collect(pool) == 0) {
+    return NULL;
+  }
+
+  widget = pool->free_list[--pool->free_nr];
+  /* 池保留一个引用，调用者销毁控件时只是减少引用计数，内存仍归池所有 */
+  widget_ref(widget);
+  pool->in_use[range_slider_pool_index_of(pool, widget)] = TRUE;
+  widget_move_resize(widget, x, y, w, h);
+  if (parent != NULL) {
+    widget_add_child(parent, widget);
+  }
+
+  return widget;
+}
+
+ret_t range_slider_pool_release(range_slider_pool_t* pool, widget_t* widget) {
+  int32_t index = 0;
+  range_slider_t* range_slider = RANGE_SLIDER(widget);
+  return_value_if_fail(pool != NULL && range_slider != NULL, RET_BAD_PARAMS);
+  return_value_if_fail(range_slider->pool == pool, RET_BAD_PARAMS);
+
+  index = range_slider_pool_index_of(pool, widget);
+  /* 重复归还会让之后的两次获取得到同一个控件 */
+  return_value_if_fail(index >= 0 && pool->in_use[index], RET_BAD_PARAMS);
+
+  /* 先在父控件上取消拖动等状态，再摘下 */
+  range_slider_reset(widget);
+  if (widget->parent != NULL) {
+    widget_remove_child(widget->parent, widget);
+  }
+  range_slider_pool_clear_listeners(widget);
+  pool->in_use[index] = FALSE;
+  pool->free_list[pool->free_nr++] = widget;
+  widget_unref(widget);
+
+  return RET_OK;
+}
+
+ret_t range_slider_pool_destroy(range_slider_pool_t* pool) {
+  uint32_t i = 0;
+  return_value_if_fail(pool != NULL, RET_BAD_PARAMS);
+
+  if (pool->in_use != NULL) {
+    range_slider_pool_collect(pool);
+  }
+
+  for (i = 0; i < pool->capacity; i++) {
+    widget_t* widget = pool->sliders != NULL ? pool->sliders[i] : NULL;
+    if (widget == NULL) {
+      continue;
+    }
+
+    RANGE_SLIDER(widget)->pool = NULL;
+    if (pool->in_use[i]) {
+      /* 仍在使用的控件交给父控件，之后按普通控件销毁 */
+      widget_unref(widget);
+    } else {
+      widget_destroy(widget);
+    }
+  }
+
+  TKMEM_FREE(pool->sliders);
+  TKMEM_FREE(pool->free_list);
+  TKMEM_FREE(pool->in_use);
+  TKMEM_FREE(pool);
+
+  return RET_OK;
+}
@@ -0,0 +1,120 @@
+﻿/**
+ * File:   range_slider_pool.h
+ * Author:
+ * Brief:  range_slider预分配池(启动后创建和销毁不再使用堆)
+ *
+ * Copyright (c) 2024 - 2024
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2026-10-19  created
+ *
+ */
+
+#ifndef TK_RANGE_SLIDER_POOL_H
+#define TK_RANGE_SLIDER_POOL_H
+
+#include "range_slider.h"
+
+BEGIN_C_DECLS
+
+/**
+ * @class range_slider_pool_t
+ * range_slider预分配池。
+ *
+ * 启动时一次性创建capacity个range_slider及其全部子控件，之后的获取和归还只是
+ * 挂到父控件上或从父控件上摘下，不再分配或释放堆内存，避免长时间运行后的碎片。
+ *
+ * * 池中的控件不需要的子控件(dragger2和label)只隐藏，不销毁。
+ * * 归还或回收时恢复为range_slider_reset之后的状态，并清除调用者在控件上注册的全部事件处理函数
+ *   (清除前分发一次EVT_DESTROY，range_slider_group等借此移除成员)。不要在控件自身的事件处理函数中归还。
+ * * 池对取出的控件保留一个引用，调用者直接销毁控件或随父控件一起销毁(如关闭窗口)时，
+ *   控件的内存不会释放，之后由range_slider_pool_collect回收到池中，容量不会减少。
+ *
+ * ```c
+ * range_slider_pool_t* pool = range_slider_pool_create(8);
+ * widget_t* slider = range_slider_pool_acquire(pool, win, 10, 10, 200, 40);
+ * ...
+ * range_slider_pool_release(pool, slider);
+ * ...
+ * range_slider_pool_destroy(pool);
+ * ```
+ */
+typedef struct _range_slider_pool_t {
+  /* 全部控件 */
+  widget_t** sliders;
+  /* 空闲控件的栈 */
+  widget_t** free_list;
+  /* sliders[i]是否已被取出 */
+  bool_t* in_use;
+  uint32_t capacity;
+  uint32_t free_nr;
+} range_slider_pool_t;
+
+/**
+ * @method range_slider_pool_create
+ * 创建预分配池，并创建capacity个控件。
+ * @annotation ["constructor"]
+ * @param {uint32_t} capacity 控件个数。
+ *
+ * @return {range_slider_pool_t*} 返回池对象，失败返回NULL。
+ */
+range_slider_pool_t* range_slider_pool_create(uint32_t capacity);
+
+/**
+ * @method range_slider_pool_acquire
+ * 从池中取出一个控件并挂到parent上。
+ * 空闲的控件用完时先回收已被销毁的控件，仍然没有时返回NULL(不会退化为堆分配)。
+ * @param {range_slider_pool_t*} pool 池对象。
+ * @param {widget_t*} parent 父控件，可为NULL。
+ * @param {xy_t} x x坐标
+ * @param {xy_t} y y坐标
+ * @param {wh_t} w 宽度
+ * @param {wh_t} h 高度
+ *
+ * @return {widget_t*} 返回控件，失败返回NULL。
+ */
+widget_t* range_slider_pool_acquire(range_slider_pool_t* pool, widget_t* parent, xy_t x, xy_t y,
+                                    wh_t w, wh_t h);
+
+/**
+ * @method range_slider_pool_release
+ * 把控件归还到池中(代替widget_destroy)。
+ * @param {range_slider_pool_t*} pool 池对象。
+ * @param {widget_t*} widget 由range_slider_pool_acquire取出的控件。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，控件已在池中(重复归还)时返回RET_BAD_PARAMS。
+ */
+ret_t range_slider_pool_release(range_slider_pool_t* pool, widget_t* widget);
+
+/**
+ * @method range_slider_pool_collect
+ * 回收已被调用者销毁(或随父控件一起销毁)的控件，恢复为缺省状态后放回空闲栈。
+ * range_slider_pool_acquire在没有空闲控件时会自动调用。
+ * @param {range_slider_pool_t*} pool 池对象。
+ *
+ * @return {uint32_t} 返回回收的控件个数。
+ */
+uint32_t range_slider_pool_collect(range_slider_pool_t* pool);
+
+/**
+ * @method range_slider_pool_destroy
+ * 销毁池及池中空闲(含已回收)的控件。已取出的控件仍归其父控件所有，之后按普通控件销毁。
+ * @annotation ["deconstructor"]
+ * @param {range_slider_pool_t*} pool 池对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_pool_destroy(range_slider_pool_t* pool);
+
+END_C_DECLS
+
+#endif /*TK_RANGE_SLIDER_POOL_H*/
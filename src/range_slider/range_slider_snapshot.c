@@ -0,0 +1,73 @@
+﻿/**
+ * File:   range_slider_snapshot.c
+ * Author:
+ * Brief:  range_slider当前区间的无锁快照(供工作线程读取)
+ *
+ * Copyright (c) 2024 - 2024
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2026-10-19  created
+ *
+ */
+
+#include "tkc/utils.h"
+#include "range_slider_snapshot.h"
+
+/* 序号的读写和内存屏障，保证数据的读写不会越过序号的读写 */
+#if defined(__GNUC__) || defined(__clang__)
+#define RANGE_SLIDER_SEQ_LOAD(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define RANGE_SLIDER_SEQ_STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define RANGE_SLIDER_SEQ_FENCE() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#elif defined(_MSC_VER)
+#include <intrin.h>
+/* x86/x64上普通的读写已经满足acquire/release，只需阻止编译器重排 */
+#define RANGE_SLIDER_SEQ_LOAD(p) (*(volatile const uint32_t*)(p))
+#define RANGE_SLIDER_SEQ_STORE(p, v) (*(volatile uint32_t*)(p) = (v))
+#define RANGE_SLIDER_SEQ_FENCE() _ReadWriteBarrier()
+#else
+/* 没有原子操作时只支持在GUI线程中使用 */
+#define RANGE_SLIDER_SEQ_LOAD(p) (*(p))
+#define RANGE_SLIDER_SEQ_STORE(p, v) (*(p) = (v))
+#define RANGE_SLIDER_SEQ_FENCE()
+#endif
+
+ret_t range_slider_snapshot_write(range_slider_snapshot_t* snapshot,
+                                  const range_slider_range_t* range) {
+  uint32_t seq = 0;
+  return_value_if_fail(snapshot != NULL && range != NULL, RET_BAD_PARAMS);
+
+  /* 只有一个写者，序号不会被别人修改 */
+  seq = snapshot->seq;
+  RANGE_SLIDER_SEQ_STORE(&(snapshot->seq), seq + 1);
+  RANGE_SLIDER_SEQ_FENCE();
+  snapshot->range = *range;
+  RANGE_SLIDER_SEQ_STORE(&(snapshot->seq), seq + 2);
+
+  return RET_OK;
+}
+
+ret_t range_slider_snapshot_read(const range_slider_snapshot_t* snapshot,
+                                 range_slider_range_t* range) {
+  uint32_t begin = 0;
+  uint32_t end = 0;
+  return_value_if_fail(snapshot != NULL && range != NULL, RET_BAD_PARAMS);
+
+  /* 读取期间序号变了(或一开始就在写入)，说明可能读到了两次写入的混合，重读 */
+  do {
+    begin = RANGE_SLIDER_SEQ_LOAD(&(snapshot->seq));
+    *range = snapshot->range;
+    RANGE_SLIDER_SEQ_FENCE();
+    end = RANGE_SLIDER_SEQ_LOAD(&(snapshot->seq));
+  } while ((begin & 1) != 0 || begin != end);
+
+  return RET_OK;
+}
@@ -0,0 +1,81 @@
+﻿/**
+ * File:   range_slider_snapshot.h
+ * Author:
+ * Brief:  range_slider当前区间的无锁快照(供工作线程读取)
+ *
+ * Copyright (c) 2024 - 2024
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2026-10-19  created
+ *
+ */
+
+#ifndef TK_RANGE_SLIDER_SNAPSHOT_H
+#define TK_RANGE_SLIDER_SNAPSHOT_H
+
+#include "tkc/types_def.h"
+
+BEGIN_C_DECLS
+
+/**
+ * @class range_slider_range_t
+ * 某一时刻的区间和范围。
+ */
+typedef struct _range_slider_range_t {
+  double value1;
+  double value2;
+  double min;
+  double max;
+} range_slider_range_t;
+
+/**
+ * @class range_slider_snapshot_t
+ * range_slider发布区间的顺序锁(seqlock)。
+ *
+ * 只有一个写者(GUI线程，由range_slider在值或范围改变时写入)，任意多个线程可以同时读取，
+ * 读取不加锁、不访问控件树，读到的value1/value2/min/max一定属于同一次写入。
+ * 写入期间的读取会重试，写入只是几次赋值，重试极少发生。
+ *
+ * 内存由调用者提供(可以是全局变量或与工作线程共享的结构体成员)，用memset清零即完成初始化，
+ * 须在所有读者结束并调用range_slider_set_snapshot(widget, NULL)之后才能释放。
+ */
+typedef struct _range_slider_snapshot_t {
+  /* 奇数表示正在写入 */
+  uint32_t seq;
+  range_slider_range_t range;
+} range_slider_snapshot_t;
+
+/**
+ * @method range_slider_snapshot_write
+ * 写入新的区间(只能在一个线程中调用)。
+ * @param {range_slider_snapshot_t*} snapshot 快照对象。
+ * @param {const range_slider_range_t*} range 区间。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_snapshot_write(range_slider_snapshot_t* snapshot,
+                                  const range_slider_range_t* range);
+
+/**
+ * @method range_slider_snapshot_read
+ * 读取一致的区间(可以在任意线程中调用)。
+ * @param {const range_slider_snapshot_t*} snapshot 快照对象。
+ * @param {range_slider_range_t*} range 返回区间。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_snapshot_read(const range_slider_snapshot_t* snapshot,
+                                 range_slider_range_t* range);
+
+END_C_DECLS
+
+#endif /*TK_RANGE_SLIDER_SNAPSHOT_H*/
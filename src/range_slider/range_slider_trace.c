@@ -0,0 +1,163 @@
+﻿/**
+ * File:   range_slider_trace.c
+ * Author:
+ * Brief:  range_slider的跟踪(布局、绘制、事件处理等的时间线)
+ *
+ * Copyright (c) 2024 - 2024
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2026-10-19  created
+ *
+ */
+
+#include "tkc/fs.h"
+#include "tkc/str.h"
+#include "tkc/utils.h"
+#include "tkc/time_now.h"
+#include "range_slider_trace.h"
+
+#if RANGE_SLIDER_WITH_TRACE
+
+typedef struct _range_slider_trace_event_t {
+  const char* name;
+  uint64_t ts;
+  uint32_t arg;
+  char phase;
+} range_slider_trace_event_t;
+
+/* 写入位置只增不减，取模得到槽位；多个线程同时写入时各自原子地占一个槽位 */
+#if defined(__GNUC__) || defined(__clang__)
+#define RANGE_SLIDER_TRACE_CLAIM(p) __atomic_fetch_add((p), 1, __ATOMIC_RELAXED)
+#define RANGE_SLIDER_TRACE_LOAD(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define RANGE_SLIDER_TRACE_CLAIM(p) ((uint32_t)_InterlockedIncrement((volatile long*)(p)) - 1)
+#define RANGE_SLIDER_TRACE_LOAD(p) (*(p))
+#else
+/* 没有原子操作时只支持在GUI线程中使用 */
+#define RANGE_SLIDER_TRACE_CLAIM(p) ((*(p))++)
+#define RANGE_SLIDER_TRACE_LOAD(p) (*(p))
+#endif
+
+static range_slider_trace_event_t s_trace_events[RANGE_SLIDER_TRACE_CAPACITY];
+static volatile uint32_t s_trace_head = 0;
+static range_slider_trace_hook_t s_trace_hook = NULL;
+static void* s_trace_hook_ctx = NULL;
+
+ret_t range_slider_trace_add(const char* name, char phase, uint32_t arg) {
+  uint64_t ts = time_now_us();
+  uint32_t index = RANGE_SLIDER_TRACE_CLAIM(&s_trace_head);
+  range_slider_trace_event_t* e = s_trace_events + (index & (RANGE_SLIDER_TRACE_CAPACITY - 1));
+
+  e->name = name;
+  e->ts = ts;
+  e->arg = arg;
+  e->phase = phase;
+
+  if (s_trace_hook != NULL) {
+    s_trace_hook(s_trace_hook_ctx, name, phase, arg, ts);
+  }
+
+  return RET_OK;
+}
+
+ret_t range_slider_trace_set_hook(range_slider_trace_hook_t hook, void* ctx) {
+  s_trace_hook = hook;
+  s_trace_hook_ctx = ctx;
+
+  return RET_OK;
+}
+
+ret_t range_slider_trace_clear(void) {
+  s_trace_head = 0;
+
+  return RET_OK;
+}
+
+uint32_t range_slider_trace_count(void) {
+  uint32_t head = RANGE_SLIDER_TRACE_LOAD(&s_trace_head);
+
+  return tk_min(head, RANGE_SLIDER_TRACE_CAPACITY);
+}
+
+ret_t range_slider_trace_to_json(str_t* str) {
+  uint32_t i = 0;
+  uint32_t head = RANGE_SLIDER_TRACE_LOAD(&s_trace_head);
+  uint32_t first = head > RANGE_SLIDER_TRACE_CAPACITY ? head - RANGE_SLIDER_TRACE_CAPACITY : 0;
+  return_value_if_fail(str != NULL, RET_BAD_PARAMS);
+
+  str_append(str, "{\"traceEvents\":[");
+  for (i = first; i < head; i++) {
+    const range_slider_trace_event_t* e =
+        s_trace_events + (i & (RANGE_SLIDER_TRACE_CAPACITY - 1));
+    if (i > first) {
+      str_append_char(str, ',');
+    }
+    str_append_format(str, 128, "{\"name\":\"%s\",\"cat\":\"range_slider\",\"ph\":\"%c\",\"ts\":",
+                      e->name, e->phase);
+    str_append_uint64(str, e->ts);
+    str_append_format(str, 64, ",\"pid\":1,\"tid\":1,\"args\":{\"arg\":%u}}", e->arg);
+  }
+  str_append(str, "],\"displayTimeUnit\":\"ms\"}");
+
+  return RET_OK;
+}
+
+ret_t range_slider_trace_dump(const char* filename) {
+  str_t str;
+  ret_t ret = RET_OK;
+  return_value_if_fail(filename != NULL, RET_BAD_PARAMS);
+
+  str_init(&str, 64 * (range_slider_trace_count() + 1));
+  ret = range_slider_trace_to_json(&str);
+  if (ret == RET_OK) {
+    ret = file_write(filename, str.str, str.size);
+  }
+  str_reset(&str);
+
+  return ret;
+}
+
+#else
+
+ret_t range_slider_trace_add(const char* name, char phase, uint32_t arg) {
+  (void)name;
+  (void)phase;
+  (void)arg;
+  return RET_NOT_IMPL;
+}
+
+ret_t range_slider_trace_set_hook(range_slider_trace_hook_t hook, void* ctx) {
+  (void)hook;
+  (void)ctx;
+  return RET_NOT_IMPL;
+}
+
+ret_t range_slider_trace_clear(void) {
+  return RET_NOT_IMPL;
+}
+
+uint32_t range_slider_trace_count(void) {
+  return 0;
+}
+
+ret_t range_slider_trace_to_json(str_t* str) {
+  (void)str;
+  return RET_NOT_IMPL;
+}
+
+ret_t range_slider_trace_dump(const char* filename) {
+  (void)filename;
+  return RET_NOT_IMPL;
+}
+
+#endif /*RANGE_SLIDER_WITH_TRACE*/
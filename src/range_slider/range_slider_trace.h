@@ -0,0 +1,134 @@
+﻿/**
+ * File:   range_slider_trace.h
+ * Author:
+ * Brief:  range_slider的跟踪(布局、绘制、事件处理等的时间线)
+ *
+ * Copyright (c) 2024 - 2024
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2026-10-19  created
+ *
+ */
+
+#ifndef TK_RANGE_SLIDER_TRACE_H
+#define TK_RANGE_SLIDER_TRACE_H
+
+#include "tkc/str.h"
+
+BEGIN_C_DECLS
+
+/*
+ * 跟踪开关：定义为1时在布局、绘制、事件处理、设置值和更新label的前后记录begin/end事件，
+ * 缺省为0，此时RANGE_SLIDER_TRACE_BEGIN/END展开为空，不产生任何代码。
+ */
+#ifndef RANGE_SLIDER_WITH_TRACE
+#define RANGE_SLIDER_WITH_TRACE 0
+#endif /*RANGE_SLIDER_WITH_TRACE*/
+
+/* 环形缓冲区能保存的事件数(须为2的幂)，写满后覆盖最早的事件 */
+#ifndef RANGE_SLIDER_TRACE_CAPACITY
+#define RANGE_SLIDER_TRACE_CAPACITY 4096
+#endif /*RANGE_SLIDER_TRACE_CAPACITY*/
+
+#define RANGE_SLIDER_TRACE_LAYOUT "range_slider.layout"
+#define RANGE_SLIDER_TRACE_PAINT "range_slider.paint"
+#define RANGE_SLIDER_TRACE_EVENT "range_slider.event"
+#define RANGE_SLIDER_TRACE_SET_VALUE "range_slider.set_value"
+#define RANGE_SLIDER_TRACE_UPDATE_LABEL "range_slider.update_label"
+
+/**
+ * @class range_slider_trace_t
+ * @annotation ["fake"]
+ * range_slider的跟踪。
+ *
+ * 事件写入一个无锁的环形缓冲区(写入位置用原子操作分配)，可以导出为Chrome trace格式的JSON文件，
+ * 在chrome://tracing或Perfetto中与一帧内的其它工作一起查看。
+ * 需要以RANGE_SLIDER_WITH_TRACE=1编译，否则下列函数返回RET_NOT_IMPL。
+ */
+
+/**
+ * @method range_slider_trace_add
+ * 记录一个事件。一般通过RANGE_SLIDER_TRACE_BEGIN/RANGE_SLIDER_TRACE_END调用。
+ * @annotation ["static"]
+ * @param {const char*} name 名称，必须是常量字符串(只保存指针)。
+ * @param {char} phase 'B'表示开始，'E'表示结束。
+ * @param {uint32_t} arg 参数(如事件处理中的事件类型、设置值时的滑块索引)。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_trace_add(const char* name, char phase, uint32_t arg);
+
+/* 钩子函数的原型，ts_us为微秒时间戳 */
+typedef ret_t (*range_slider_trace_hook_t)(void* ctx, const char* name, char phase, uint32_t arg,
+                                          uint64_t ts_us);
+
+/**
+ * @method range_slider_trace_set_hook
+ * 设置钩子函数，每个事件在写入缓冲区的同时转发给钩子(如接入应用自己的跟踪系统)。
+ * @annotation ["static"]
+ * @param {range_slider_trace_hook_t} hook 钩子函数，为NULL时取消。
+ * @param {void*} ctx 钩子函数的上下文。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_trace_set_hook(range_slider_trace_hook_t hook, void* ctx);
+
+/**
+ * @method range_slider_trace_clear
+ * 清空缓冲区。
+ * @annotation ["static"]
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_trace_clear(void);
+
+/**
+ * @method range_slider_trace_count
+ * 获取缓冲区中的事件个数(最多为RANGE_SLIDER_TRACE_CAPACITY)。
+ * @annotation ["static"]
+ *
+ * @return {uint32_t} 返回事件个数。
+ */
+uint32_t range_slider_trace_count(void);
+
+/**
+ * @method range_slider_trace_to_json
+ * 把缓冲区中的事件按时间顺序输出为Chrome trace格式的JSON。
+ * 输出时其它线程不应同时写入，否则可能读到写了一半的事件。
+ * @annotation ["static"]
+ * @param {str_t*} str 输出的字符串(追加)。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_trace_to_json(str_t* str);
+
+/**
+ * @method range_slider_trace_dump
+ * 把缓冲区中的事件写入本地文件(Chrome trace格式的JSON)。
+ * @annotation ["static"]
+ * @param {const char*} filename 文件名。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t range_slider_trace_dump(const char* filename);
+
+#if RANGE_SLIDER_WITH_TRACE
+#define RANGE_SLIDER_TRACE_BEGIN(name, arg) range_slider_trace_add(name, 'B', arg)
+#define RANGE_SLIDER_TRACE_END(name, arg) range_slider_trace_add(name, 'E', arg)
+#else
+#define RANGE_SLIDER_TRACE_BEGIN(name, arg)
+#define RANGE_SLIDER_TRACE_END(name, arg)
+#endif /*RANGE_SLIDER_WITH_TRACE*/
+
+END_C_DECLS
+
+#endif /*TK_RANGE_SLIDER_TRACE_H*/
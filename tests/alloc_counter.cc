@@ -0,0 +1,101 @@
+﻿#include <stdlib.h>
+#include "alloc_counter.h"
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t nmemb, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+}
+
+static bool_t s_counting = FALSE;
+static uint32_t s_alloc_count = 0;
+static int64_t s_live_bytes = 0;
+static int64_t s_peak_bytes = 0;
+
+static void alloc_counter_add(void* ptr) {
+  if (ptr != NULL) {
+    s_live_bytes += malloc_usable_size(ptr);
+    if (s_live_bytes > s_peak_bytes) {
+      s_peak_bytes = s_live_bytes;
+    }
+  }
+}
+
+static void alloc_counter_sub(void* ptr) {
+  if (ptr != NULL) {
+    s_live_bytes -= malloc_usable_size(ptr);
+  }
+}
+
+extern "C" void* malloc(size_t size) {
+  void* ret = __libc_malloc(size);
+  if (s_counting) {
+    s_alloc_count++;
+    alloc_counter_add(ret);
+  }
+  return ret;
+}
+
+extern "C" void* calloc(size_t nmemb, size_t size) {
+  void* ret = __libc_calloc(nmemb, size);
+  if (s_counting) {
+    s_alloc_count++;
+    alloc_counter_add(ret);
+  }
+  return ret;
+}
+
+extern "C" void* realloc(void* ptr, size_t size) {
+  void* ret = NULL;
+  if (s_counting) {
+    s_alloc_count++;
+    alloc_counter_sub(ptr);
+  }
+  ret = __libc_realloc(ptr, size);
+  if (s_counting) {
+    alloc_counter_add(ret);
+  }
+  return ret;
+}
+
+extern "C" void free(void* ptr) {
+  if (s_counting) {
+    alloc_counter_sub(ptr);
+  }
+  __libc_free(ptr);
+}
+
+bool_t alloc_counter_supported(void) {
+  return TRUE;
+}
+#else
+static bool_t s_counting = FALSE;
+static uint32_t s_alloc_count = 0;
+static int64_t s_peak_bytes = 0;
+
+bool_t alloc_counter_supported(void) {
+  return FALSE;
+}
+#endif /*__GLIBC__*/
+
+void alloc_counter_start(void) {
+  s_alloc_count = 0;
+#if defined(__GLIBC__)
+  s_live_bytes = 0;
+#endif /*__GLIBC__*/
+  s_peak_bytes = 0;
+  s_counting = TRUE;
+}
+
+uint32_t alloc_counter_stop(void) {
+  s_counting = FALSE;
+  return s_alloc_count;
+}
+
+int64_t alloc_counter_peak_bytes(void) {
+  return s_peak_bytes;
+}
@@ -0,0 +1,25 @@
+﻿#ifndef TK_ALLOC_COUNTER_H
+#define TK_ALLOC_COUNTER_H
+
+#include "tkc/types_def.h"
+
+BEGIN_C_DECLS
+
+/*
+ * 统计一段代码中的堆分配次数(malloc/calloc/realloc)。
+ * tkc的std分配器最终调用malloc，因此同样能统计到TKMEM_ALLOC等分配。
+ * 目前只支持glibc，不支持时测试应跳过。
+ */
+bool_t alloc_counter_supported(void);
+void alloc_counter_start(void);
+uint32_t alloc_counter_stop(void);
+
+/*
+ * 从alloc_counter_start开始，堆上占用字节数相对起点的最高值(high-water mark)。
+ * 在alloc_counter_stop之后调用，返回的是上一次统计的结果。
+ */
+int64_t alloc_counter_peak_bytes(void);
+
+END_C_DECLS
+
+#endif /*TK_ALLOC_COUNTER_H*/
@@ -0,0 +1,390 @@
+﻿#include "tkc/mem.h"
+#include "tkc/str.h"
+#include "tkc/utils.h"
+#include "tkc/time_now.h"
+#include "base/canvas.h"
+#include "lcd/lcd_mem_bgra8888.h"
+#include "ui_loader/ui_builder_default.h"
+#include "ui_loader/ui_loader_xml.h"
+#include "widgets/view.h"
+#include "range_slider/range_slider.h"
+#include "range_slider_register.h"
+#include "gtest/gtest.h"
+#include <math.h>
+
+#define BENCH_DATA_NR 10000000
+#define BENCH_STEPS 100000
+#define BENCH_LINEAR_STEPS 100
+#define BENCH_PAINT_TIMES 10000
+#define BENCH_LCD_W 400
+#define BENCH_LCD_H 100
+#define BENCH_ROWS 1000
+#define BENCH_PAGE_SLIDERS 60
+#define BENCH_PAGE_TIMES 100
+#define BENCH_ALLOWED_NR 50000
+#define BENCH_PRESET_SLIDERS 10000
+#define BENCH_PRESET_TIMES 10
+
+static const char* s_bench_row_xml =
+    "<view x=\"0\" y=\"0\" w=\"400\" h=\"40\">"
+    "<range_slider x=\"0\" y=\"0\" w=\"400\" h=\"40\" min=\"0\" max=\"1000\" step=\"5\" "
+    "value1=\"100\" value2=\"800\" bar_size=\"4\" dragger_style=\"range_slider_default\" "
+    "style=\"range_slider_default\" value_label_style=\"range_slider_default\" "
+    "range_label_style=\"range_slider_default_no_border\" range_slider_view_width_ratio=\"0.85\" "
+    "range_slider_view_height_ratio=\"0.5\" value_label_width=\"50\" range_label_gap=\"5\"/>"
+    "</view>";
+
+static widget_t* bench_load_row(void) {
+  widget_t* root = NULL;
+  ui_builder_t* builder = ui_builder_default_create("row");
+
+  ui_loader_load(xml_ui_loader(), (const uint8_t*)s_bench_row_xml, strlen(s_bench_row_xml),
+                 builder);
+  root = builder->root;
+  ui_builder_destroy(builder);
+
+  return root;
+}
+
+static widget_t* bench_load_page(const char* xml) {
+  widget_t* root = NULL;
+  ui_builder_t* builder = ui_builder_default_create("page");
+
+  ui_loader_load(xml_ui_loader(), (const uint8_t*)xml, strlen(xml), builder);
+  root = builder->root;
+  ui_builder_destroy(builder);
+
+  return root;
+}
+
+typedef struct _bench_canvas_t {
+  canvas_t c;
+  lcd_t* lcd;
+  uint8_t* fb;
+} bench_canvas_t;
+
+static canvas_t* bench_canvas_init(bench_canvas_t* bc) {
+  rect_t r = rect_init(0, 0, BENCH_LCD_W, BENCH_LCD_H);
+
+  bc->fb = TKMEM_ZALLOCN(uint8_t, BENCH_LCD_W * BENCH_LCD_H * 4);
+  bc->lcd = lcd_mem_bgra8888_create_single_fb(BENCH_LCD_W, BENCH_LCD_H, bc->fb);
+  canvas_init(&(bc->c), bc->lcd, font_manager());
+  canvas_begin_frame(&(bc->c), &r, LCD_DRAW_NORMAL);
+
+  return &(bc->c);
+}
+
+static void bench_canvas_deinit(bench_canvas_t* bc) {
+  canvas_end_frame(&(bc->c));
+  canvas_reset(&(bc->c));
+  lcd_destroy(bc->lcd);
+  TKMEM_FREE(bc->fb);
+}
+
+static uint32_t bench_linear_count(const double* data, uint32_t nr, double lo, double hi) {
+  uint32_t count = 0;
+
+  for (uint32_t i = 0; i < nr; i++) {
+    if (data[i] >= lo && data[i] <= hi) {
+      count++;
+    }
+  }
+
+  return count;
+}
+
+TEST(range_slider_bench, count_in_range_10m) {
+  value_t v;
+  uint64_t start = 0;
+  uint64_t cost = 0;
+  uint64_t linear_cost = 0;
+  uint32_t linear_count = 0;
+  double* data = TKMEM_ZALLOCN(double, BENCH_DATA_NR);
+  double* prefix_sum = TKMEM_ZALLOCN(double, BENCH_DATA_NR + 1);
+  widget_t* w = range_slider_create(NULL, 0, 0, 400, 40);
+  ASSERT_TRUE(data != NULL && prefix_sum != NULL && w != NULL);
+
+  for (uint32_t i = 0; i < BENCH_DATA_NR; i++) {
+    data[i] = i;
+    prefix_sum[i + 1] = prefix_sum[i] + data[i];
+  }
+
+  value_set_double(&v, BENCH_DATA_NR);
+  widget_set_prop(w, WIDGET_PROP_MAX, &v);
+  ASSERT_EQ(range_slider_set_dataset(w, data, prefix_sum, BENCH_DATA_NR), RET_OK);
+
+  start = time_now_us();
+  for (uint32_t i = 0; i < BENCH_STEPS; i++) {
+    value_set_double(&v, BENCH_DATA_NR / 2 + (i % 1000) + 1);
+    widget_set_prop(w, RANGE_SLIDER_PROP_VALUE2, &v);
+  }
+  cost = time_now_us() - start;
+
+  start = time_now_us();
+  for (uint32_t i = 0; i < BENCH_LINEAR_STEPS; i++) {
+    linear_count = bench_linear_count(data, BENCH_DATA_NR, RANGE_SLIDER(w)->value1,
+                                      BENCH_DATA_NR / 2 + (i % 1000) + 1);
+  }
+  linear_cost = time_now_us() - start;
+  ASSERT_GT(linear_count, 0u);
+
+  printf("count_in_range(%u items): %.3f us/step (binary search), %.3f us/step (linear scan)\n",
+         BENCH_DATA_NR, (double)cost / BENCH_STEPS, (double)linear_cost / BENCH_LINEAR_STEPS);
+
+  widget_destroy(w);
+  TKMEM_FREE(data);
+  TKMEM_FREE(prefix_sum);
+}
+
+TEST(range_slider_bench, allowed_values_50k) {
+  uint64_t start = 0;
+  uint64_t snap_cost = 0;
+  uint64_t key_cost = 0;
+  double* values = TKMEM_ZALLOCN(double, BENCH_ALLOWED_NR);
+  widget_t* w = range_slider_create(NULL, 0, 0, 400, 40);
+  range_slider_t* range_slider = RANGE_SLIDER(w);
+  ASSERT_TRUE(values != NULL && w != NULL);
+
+  /* 非均匀分布(对数刻度)的允许值，如滤波器的截止频率 */
+  for (uint32_t i = 0; i < BENCH_ALLOWED_NR; i++) {
+    values[i] = 20 * pow(1000.0, (double)i / BENCH_ALLOWED_NR);
+  }
+  widget_set_prop_double(w, WIDGET_PROP_MAX, 20000);
+  ASSERT_EQ(range_slider_set_allowed_values(w, values, BENCH_ALLOWED_NR), RET_OK);
+  widget_set_prop_double(w, RANGE_SLIDER_PROP_VALUE2, 20000);
+
+  start = time_now_us();
+  for (uint32_t i = 0; i < BENCH_STEPS; i++) {
+    widget_set_prop_double(w, RANGE_SLIDER_PROP_VALUE1, 20 + (i % 10000) * 1.7);
+  }
+  snap_cost = time_now_us() - start;
+
+  widget_set_prop_double(w, RANGE_SLIDER_PROP_VALUE1, values[0]);
+  widget_set_prop_bool(range_slider->dragger1, WIDGET_PROP_VALUE, TRUE);
+  start = time_now_us();
+  for (uint32_t i = 0; i < BENCH_STEPS; i++) {
+    key_event_t e;
+    key_event_init(&e, EVT_KEY_DOWN, range_slider->dragger1,
+                   (i / 1000) % 2 ? TK_KEY_LEFT : TK_KEY_RIGHT);
+    widget_dispatch(range_slider->dragger1, (event_t*)&e);
+  }
+  key_cost = time_now_us() - start;
+  /* 左右各走了相同的步数 */
+  ASSERT_EQ(range_slider->value1, values[0]);
+
+  printf("allowed_values(%u items): %.3f us/snap, %.3f us/key step\n", BENCH_ALLOWED_NR,
+         (double)snap_cost / BENCH_STEPS, (double)key_cost / BENCH_STEPS);
+
+  widget_destroy(w);
+  TKMEM_FREE(values);
+}
+
+TEST(range_slider_bench, paint_style_cache) {
+  bench_canvas_t bc;
+  uint64_t start = 0;
+  uint64_t cached_cost = 0;
+  uint64_t uncached_cost = 0;
+  canvas_t* c = bench_canvas_init(&bc);
+  widget_t* w = range_slider_create(NULL, 0, 0, BENCH_LCD_W, 40);
+  widget_layout(w);
+
+  start = time_now_us();
+  for (uint32_t i = 0; i < BENCH_PAINT_TIMES; i++) {
+    w->vt->on_paint_self(w, c);
+  }
+  cached_cost = time_now_us() - start;
+
+  start = time_now_us();
+  for (uint32_t i = 0; i < BENCH_PAINT_TIMES; i++) {
+    range_slider_invalidate_style_cache(w);
+    w->vt->on_paint_self(w, c);
+  }
+  uncached_cost = time_now_us() - start;
+
+  printf("on_paint_self: %.3f us/paint (style cache), %.3f us/paint (resolve every paint)\n",
+         (double)cached_cost / BENCH_PAINT_TIMES, (double)uncached_cost / BENCH_PAINT_TIMES);
+
+  widget_destroy(w);
+  bench_canvas_deinit(&bc);
+}
+
+TEST(range_slider_bench, track_draw_calls) {
+  bench_canvas_t bc;
+  uint64_t start = 0;
+  uint64_t cost = 0;
+  canvas_t* c = bench_canvas_init(&bc);
+  widget_t* w = range_slider_create(NULL, 0, 0, BENCH_LCD_W, 40);
+  widget_layout(w);
+
+  start = time_now_us();
+  for (uint32_t i = 0; i < BENCH_PAINT_TIMES; i++) {
+    w->vt->on_paint_self(w, c);
+  }
+  cost = time_now_us() - start;
+
+  /* 背景一次，前景在OpenGL下合并为一次，AGGE下每段一次 */
+  ASSERT_LE(RANGE_SLIDER(w)->track_draw_calls, 3u);
+  printf("track: %u fills/slider, %.3f us/paint\n", RANGE_SLIDER(w)->track_draw_calls,
+         (double)cost / BENCH_PAINT_TIMES);
+
+  widget_destroy(w);
+  bench_canvas_deinit(&bc);
+}
+
+TEST(range_slider_bench, clone_rows) {
+  uint64_t start = 0;
+  uint64_t clone_cost = 0;
+  uint64_t load_cost = 0;
+  widget_t* rows[BENCH_ROWS];
+  widget_t* tmpl = NULL;
+
+  range_slider_register();
+  tmpl = bench_load_row();
+  ASSERT_TRUE(tmpl != NULL);
+  widget_layout(tmpl);
+
+  start = time_now_us();
+  for (uint32_t i = 0; i < BENCH_ROWS; i++) {
+    rows[i] = widget_clone(tmpl, NULL);
+  }
+  clone_cost = time_now_us() - start;
+  ASSERT_EQ(RANGE_SLIDER(widget_get_child(rows[0], 0))->value2, 800);
+  for (uint32_t i = 0; i < BENCH_ROWS; i++) {
+    widget_destroy(rows[i]);
+  }
+
+  start = time_now_us();
+  for (uint32_t i = 0; i < BENCH_ROWS; i++) {
+    rows[i] = bench_load_row();
+  }
+  load_cost = time_now_us() - start;
+  for (uint32_t i = 0; i < BENCH_ROWS; i++) {
+    widget_destroy(rows[i]);
+  }
+
+  printf("%u rows: %.3f ms (widget_clone), %.3f ms (load from xml)\n", BENCH_ROWS,
+         clone_cost / 1000.0, load_cost / 1000.0);
+
+  widget_destroy(tmpl);
+}
+
+TEST(range_slider_bench, rebind_vs_create) {
+  uint64_t start = 0;
+  uint64_t create_cost = 0;
+  uint64_t rebind_cost = 0;
+  range_slider_config_t config;
+  widget_t* w = range_slider_create(NULL, 0, 0, 400, 40);
+  range_slider_get_config(w, &config);
+
+  start = time_now_us();
+  for (uint32_t i = 0; i < BENCH_ROWS; i++) {
+    widget_t* row = range_slider_create(NULL, 0, 0, 400, 40);
+    widget_destroy(row);
+  }
+  create_cost = time_now_us() - start;
+
+  start = time_now_us();
+  for (uint32_t i = 0; i < BENCH_ROWS; i++) {
+    config.value1 = i % 50;
+    config.value2 = 50 + i % 50;
+    range_slider_rebind(w, &config);
+  }
+  rebind_cost = time_now_us() - start;
+
+  printf("%u rows: %.3f ms (create/destroy), %.3f ms (rebind)\n", BENCH_ROWS,
+         create_cost / 1000.0, rebind_cost / 1000.0);
+
+  widget_destroy(w);
+}
+
+TEST(range_slider_bench, settings_page_first_frame) {
+  str_t xml;
+  bench_canvas_t bc;
+  uint64_t start = 0;
+  uint64_t cost = 0;
+  canvas_t* c = bench_canvas_init(&bc);
+
+  range_slider_register();
+  str_init(&xml, 64 * 1024);
+  str_append(&xml, "<view x=\"0\" y=\"0\" w=\"400\" h=\"2400\">");
+  for (uint32_t i = 0; i < BENCH_PAGE_SLIDERS; i++) {
+    char row[512];
+    tk_snprintf(row, sizeof(row),
+                "<range_slider x=\"0\" y=\"%u\" w=\"400\" h=\"40\" value1=\"%u\" "
+                "value2=\"800\" min=\"0\" max=\"1000\" step=\"5\" bar_size=\"4\" "
+                "dragger_size=\"12\" dragger_style=\"range_slider_default\" "
+                "no_use_second_dragger=\"%s\" range_label_visible=\"true\" "
+                "value_label_visible=\"true\"/>",
+                i * 40, 100 + i, (i % 2) ? "true" : "false");
+    str_append(&xml, row);
+  }
+  str_append(&xml, "</view>");
+
+  start = time_now_us();
+  for (uint32_t i = 0; i < BENCH_PAGE_TIMES; i++) {
+    widget_t* page = bench_load_page(xml.str);
+    widget_layout(page);
+    widget_paint(page, c);
+    widget_destroy(page);
+  }
+  cost = time_now_us() - start;
+
+  printf("%u sliders: %.3f ms/page (load + layout + first paint)\n", BENCH_PAGE_SLIDERS,
+         cost / 1000.0 / BENCH_PAGE_TIMES);
+
+  str_reset(&xml);
+  bench_canvas_deinit(&bc);
+}
+
+TEST(range_slider_bench, state_presets_10k) {
+  wbuffer_t wb;
+  rbuffer_t rb;
+  uint64_t start = 0;
+  uint64_t prop_cost = 0;
+  uint64_t save_cost = 0;
+  uint64_t load_cost = 0;
+  widget_t* root = view_create(NULL, 0, 0, 400, 400);
+
+  for (uint32_t i = 0; i < BENCH_PRESET_SLIDERS; i++) {
+    widget_t* w = range_slider_create(root, 0, (i % 10) * 40, 400, 40);
+    range_slider_set_bounds(w, 0, 1000);
+    range_slider_set_range(w, i % 500, 500 + i % 500, FALSE);
+  }
+
+  /* 逐个属性设置，作为对比 */
+  start = time_now_us();
+  for (uint32_t n = 0; n < BENCH_PRESET_TIMES; n++) {
+    for (uint32_t i = 0; i < root->children->size; i++) {
+      widget_t* w = WIDGET(root->children->elms[i]);
+      widget_set_prop_double(w, WIDGET_PROP_MIN, 0);
+      widget_set_prop_double(w, WIDGET_PROP_MAX, 1000 + n);
+      widget_set_prop_double(w, WIDGET_PROP_STEP, 1);
+      widget_set_prop_double(w, RANGE_SLIDER_PROP_VALUE1, (i + n) % 500);
+      widget_set_prop_double(w, RANGE_SLIDER_PROP_VALUE2, 500 + (i + n) % 500);
+    }
+  }
+  prop_cost = time_now_us() - start;
+
+  wbuffer_init_extendable(&wb);
+  start = time_now_us();
+  for (uint32_t n = 0; n < BENCH_PRESET_TIMES; n++) {
+    wb.cursor = 0;
+    ASSERT_EQ(range_slider_save_states(root, &wb), RET_OK);
+  }
+  save_cost = time_now_us() - start;
+
+  start = time_now_us();
+  for (uint32_t n = 0; n < BENCH_PRESET_TIMES; n++) {
+    rbuffer_init(&rb, wb.data, wb.cursor);
+    ASSERT_EQ(range_slider_load_states(root, &rb), RET_OK);
+  }
+  load_cost = time_now_us() - start;
+
+  printf("%u sliders: %.3f ms (set_prop), %.3f ms (save_states, %u bytes), %.3f ms (load_states)\n",
+         BENCH_PRESET_SLIDERS, prop_cost / 1000.0 / BENCH_PRESET_TIMES,
+         save_cost / 1000.0 / BENCH_PRESET_TIMES, wb.cursor,
+         load_cost / 1000.0 / BENCH_PRESET_TIMES);
+
+  wbuffer_deinit(&wb);
+  widget_destroy(root);
+}
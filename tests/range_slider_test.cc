@@ -1,9 +1,1455 @@
-﻿#include "range_slider/range_slider.h"
+﻿#include "tkc/mem.h"
+#include "tkc/thread.h"
+#include "base/idle.h"
+#include "base/system_info.h"
+#include "range_slider/range_slider.h"
+#include "range_slider/range_slider_pool.h"
+#include "range_slider/range_slider_group.h"
+#include "range_slider/range_slider_trace.h"
+#include "base/window.h"
+#include "widgets/view.h"
+#include "lcd/lcd_mem_bgra8888.h"
+#include "alloc_counter.h"
 #include "gtest/gtest.h"
 
+#define ASSERT_RANGE(w, v1, v2)              \
+  ASSERT_EQ(RANGE_SLIDER(w)->value1, (v1)); \
+  ASSERT_EQ(RANGE_SLIDER(w)->value2, (v2));
+
 TEST(range_slider, basic) {
   value_t v;
   widget_t* w = range_slider_create(NULL, 10, 20, 30, 40);
 
   widget_destroy(w);
 }
+
+TEST(range_slider, dataset) {
+  value_t v;
+  double data[] = {10, 20, 30, 40, 50, 60, 70, 80, 90, 100};
+  double prefix_sum[ARRAY_SIZE(data) + 1] = {0};
+  widget_t* w = range_slider_create(NULL, 10, 20, 300, 40);
+
+  for (uint32_t i = 0; i < ARRAY_SIZE(data); i++) {
+    prefix_sum[i + 1] = prefix_sum[i] + data[i];
+  }
+
+  ASSERT_EQ(range_slider_set_dataset(w, data, prefix_sum, ARRAY_SIZE(data)), RET_OK);
+  ASSERT_EQ(widget_get_prop(w, RANGE_SLIDER_PROP_COUNT_IN_RANGE, &v), RET_OK);
+  ASSERT_EQ(value_uint32(&v), 4u);
+  ASSERT_EQ(widget_get_prop(w, RANGE_SLIDER_PROP_SUM_IN_RANGE, &v), RET_OK);
+  ASSERT_EQ(value_double(&v), 140);
+  ASSERT_EQ(widget_get_prop(w, RANGE_SLIDER_PROP_MEAN_IN_RANGE, &v), RET_OK);
+  ASSERT_EQ(value_double(&v), 35);
+
+  value_set_double(&v, 95);
+  ASSERT_EQ(widget_set_prop(w, RANGE_SLIDER_PROP_VALUE2, &v), RET_OK);
+  ASSERT_EQ(RANGE_SLIDER(w)->count_in_range, 8u);
+
+  value_set_double(&v, 0);
+  ASSERT_EQ(widget_set_prop(w, RANGE_SLIDER_PROP_VALUE1, &v), RET_OK);
+  ASSERT_EQ(RANGE_SLIDER(w)->count_in_range, 9u);
+
+  ASSERT_EQ(range_slider_set_dataset(w, NULL, NULL, 0), RET_OK);
+  ASSERT_EQ(RANGE_SLIDER(w)->count_in_range, 0u);
+
+  widget_destroy(w);
+}
+
+TEST(range_slider, histogram) {
+  value_t v;
+  /* 10个宽度为10的桶，每个桶5个数据 */
+  double prefix_count[11] = {0};
+  widget_t* w = range_slider_create(NULL, 10, 20, 300, 40);
+
+  for (uint32_t i = 0; i < 10; i++) {
+    prefix_count[i + 1] = prefix_count[i] + 5;
+  }
+
+  ASSERT_EQ(range_slider_set_histogram(w, 0, 10, prefix_count, NULL, 10), RET_OK);
+  /* [20, 50]覆盖第2~5个桶 */
+  ASSERT_EQ(RANGE_SLIDER(w)->count_in_range, 20u);
+  ASSERT_EQ(RANGE_SLIDER(w)->sum_in_range, 0);
+
+  value_set_double(&v, 100);
+  ASSERT_EQ(widget_set_prop(w, RANGE_SLIDER_PROP_VALUE2, &v), RET_OK);
+  ASSERT_EQ(RANGE_SLIDER(w)->count_in_range, 40u);
+
+  widget_destroy(w);
+}
+
+TEST(range_slider, histogram_out_of_range) {
+  uint32_t count = 0;
+  double sum = 0;
+  double prefix_count[11] = {0};
+  double prefix_sum[11] = {0};
+  range_slider_dataset_t ds;
+
+  for (uint32_t i = 0; i < 10; i++) {
+    prefix_count[i + 1] = prefix_count[i] + 5;
+    prefix_sum[i + 1] = prefix_sum[i] + 100;
+  }
+  memset(&ds, 0x00, sizeof(ds));
+  ds.prefix_count = prefix_count;
+  ds.prefix_sum = prefix_sum;
+  ds.nr = 10;
+  ds.start = 0;
+  ds.bin_width = 10;
+
+  /* 整个在左侧或右侧时不计入首尾桶 */
+  ASSERT_EQ(range_slider_dataset_query(&ds, -30, -5, &count, &sum), RET_OK);
+  ASSERT_EQ(count, 0u);
+  ASSERT_EQ(sum, 0);
+  ASSERT_EQ(range_slider_dataset_query(&ds, 100, 120, &count, &sum), RET_OK);
+  ASSERT_EQ(count, 0u);
+  ASSERT_EQ(sum, 0);
+
+  /* 部分重叠时仍按整桶计入 */
+  ASSERT_EQ(range_slider_dataset_query(&ds, -5, 5, &count, &sum), RET_OK);
+  ASSERT_EQ(count, 5u);
+  ASSERT_EQ(sum, 100);
+  ASSERT_EQ(range_slider_dataset_query(&ds, 95, 120, &count, &sum), RET_OK);
+  ASSERT_EQ(count, 5u);
+  ASSERT_EQ(sum, 100);
+}
+
+TEST(range_slider, layout_unchanged_no_alloc) {
+  value_t v;
+  widget_t* w = range_slider_create(NULL, 10, 20, 300, 40);
+  widget_t* label_max = NULL;
+
+  ASSERT_EQ(w->vt->on_layout_children(w), RET_OK);
+  label_max = widget_lookup(w, RANGE_SLIDER_SUB_WIDGET_LABEL_MAX, TRUE);
+  ASSERT_TRUE(label_max != NULL);
+  if (!alloc_counter_supported()) {
+    widget_destroy(w);
+    GTEST_SKIP();
+  }
+
+  alloc_counter_start();
+  ASSERT_EQ(w->vt->on_layout_children(w), RET_OK);
+  ASSERT_EQ(w->vt->on_layout_children(w), RET_OK);
+  ASSERT_EQ(alloc_counter_stop(), 0u);
+
+  /* 范围变化时就地更新label，布局缓存保持有效 */
+  value_set_double(&v, 200);
+  ASSERT_EQ(widget_set_prop(w, WIDGET_PROP_MAX, &v), RET_OK);
+  ASSERT_EQ(w->vt->on_layout_children(w), RET_OK);
+  ASSERT_EQ(wstr_eq(&(label_max->text), L"200"), TRUE);
+
+  widget_destroy(w);
+}
+
+TEST(range_slider, long_label_text) {
+  uint32_t i = 0;
+  char expected[256] = {0};
+  wchar_t wexpected[256] = {0};
+  widget_t* w = range_slider_create(NULL, 10, 20, 300, 40);
+  widget_t* label_max = NULL;
+
+  ASSERT_EQ(w->vt->on_layout_children(w), RET_OK);
+  label_max = widget_lookup(w, RANGE_SLIDER_SUB_WIDGET_LABEL_MAX, TRUE);
+  ASSERT_TRUE(label_max != NULL);
+
+  /* 41位，超过了预留的缓冲区，仍然完整显示 */
+  widget_set_prop_double(w, WIDGET_PROP_MAX, 1e40);
+  tk_snprintf(expected, sizeof(expected), "%.f", 1e40);
+  for (i = 0; expected[i] != '\0'; i++) {
+    wexpected[i] = expected[i];
+  }
+  ASSERT_EQ(label_max->text.size, strlen(expected));
+  ASSERT_EQ(wstr_eq(&(label_max->text), wexpected), TRUE);
+
+  /* 约200位，栈上的缓冲区放不下，截断后改从堆上分配，仍然完整显示 */
+  widget_set_prop_double(w, WIDGET_PROP_MAX, 1e200);
+  memset(wexpected, 0x00, sizeof(wexpected));
+  tk_snprintf(expected, sizeof(expected), "%.f", 1e200);
+  for (i = 0; expected[i] != '\0'; i++) {
+    wexpected[i] = expected[i];
+  }
+  ASSERT_EQ(label_max->text.size, strlen(expected));
+  ASSERT_EQ(wstr_eq(&(label_max->text), wexpected), TRUE);
+
+  widget_destroy(w);
+}
+
+TEST(range_slider, lazy_children) {
+  widget_t* w = range_slider_create(NULL, 10, 20, 300, 40);
+  range_slider_t* range_slider = RANGE_SLIDER(w);
+
+  /* 单滑块、不显示label时只需要view和dragger1 */
+  widget_set_prop_bool(w, RANGE_SLIDER_PROP_NO_USE_SECOND_DRAGGER, TRUE);
+  widget_set_prop_bool(w, RANGE_SLIDER_PROP_RANGE_LABEL_VISIBLE, FALSE);
+  widget_set_prop_bool(w, RANGE_SLIDER_PROP_VALUE_LABEL_VISIBLE, FALSE);
+  ASSERT_EQ(w->vt->on_layout_children(w), RET_OK);
+  ASSERT_EQ(w->children->size, 1u);
+  ASSERT_EQ(range_slider->view->children->size, 1u);
+  ASSERT_TRUE(range_slider->dragger2 == NULL);
+  ASSERT_TRUE(range_slider->label_min == NULL && range_slider->label_value1 == NULL);
+
+  /* 按需创建 */
+  widget_set_prop_bool(w, RANGE_SLIDER_PROP_VALUE_LABEL_VISIBLE, TRUE);
+  ASSERT_TRUE(range_slider->label_value1 != NULL);
+  ASSERT_TRUE(range_slider->label_value2 == NULL);
+  widget_set_prop_bool(w, RANGE_SLIDER_PROP_NO_USE_SECOND_DRAGGER, FALSE);
+  ASSERT_TRUE(range_slider->dragger2 != NULL);
+  ASSERT_TRUE(range_slider->label_value2 != NULL);
+  ASSERT_TRUE(widget_lookup(w, RANGE_SLIDER_SUB_WIDGET_DRAGGER2, TRUE) == range_slider->dragger2);
+  ASSERT_EQ(w->vt->on_layout_children(w), RET_OK);
+
+  widget_destroy(w);
+}
+
+TEST(range_slider, persistent_properties) {
+  value_t v;
+  widget_t* w = range_slider_create(NULL, 10, 20, 300, 40);
+  const char** props = w->vt->persistent_properties;
+
+  ASSERT_TRUE(props != NULL && props[0] != NULL);
+  for (uint32_t i = 0; props[i] != NULL; i++) {
+    ASSERT_EQ(widget_get_prop(w, props[i], &v), RET_OK) << props[i];
+  }
+
+  widget_destroy(w);
+}
+
+TEST(range_slider, clone) {
+  value_t v;
+  widget_t* w = range_slider_create(NULL, 10, 20, 300, 40);
+  widget_t* c = NULL;
+
+  value_set_double(&v, 1000);
+  widget_set_prop(w, WIDGET_PROP_MAX, &v);
+  value_set_double(&v, 5);
+  widget_set_prop(w, WIDGET_PROP_STEP, &v);
+  value_set_double(&v, 800);
+  widget_set_prop(w, RANGE_SLIDER_PROP_VALUE2, &v);
+  value_set_double(&v, 100);
+  widget_set_prop(w, RANGE_SLIDER_PROP_VALUE1, &v);
+  widget_set_prop_str(w, RANGE_SLIDER_PROP_DRAGGER_STYLE, "no_dragger");
+  widget_set_prop_bool(w, RANGE_SLIDER_PROP_RANGE_LABEL_VISIBLE, FALSE);
+  w->vt->on_layout_children(w);
+
+  c = widget_clone(w, NULL);
+  ASSERT_TRUE(c != NULL);
+  ASSERT_EQ(c->children->size, w->children->size);
+  ASSERT_EQ(RANGE_SLIDER(c)->max, 1000);
+  ASSERT_EQ(RANGE_SLIDER(c)->step, 5);
+  ASSERT_EQ(RANGE_SLIDER(c)->value1, 100);
+  ASSERT_EQ(RANGE_SLIDER(c)->value2, 800);
+  ASSERT_STREQ(RANGE_SLIDER(c)->dragger_style, "no_dragger");
+  ASSERT_EQ(RANGE_SLIDER(c)->range_label_visible, FALSE);
+  ASSERT_EQ(RANGE_SLIDER(c)->layout.valid, TRUE);
+
+  widget_destroy(c);
+  widget_destroy(w);
+}
+
+static ret_t on_value_event_count(void* ctx, event_t* e) {
+  uint32_t* count = (uint32_t*)ctx;
+  (*count)++;
+  return RET_OK;
+}
+
+TEST(range_slider, rebind) {
+  uint32_t count = 0;
+  range_slider_config_t config;
+  widget_t* w = range_slider_create(NULL, 10, 20, 300, 40);
+
+  for (uint32_t type = EVT_VALUE1_WILL_CHANGE; type <= EVT_VALUE2_CHANGED; type++) {
+    widget_on(w, type, on_value_event_count, &count);
+  }
+
+  ASSERT_EQ(range_slider_get_config(w, &config), RET_OK);
+  config.min = -50;
+  config.max = 50;
+  config.value1 = -10;
+  config.value2 = 30;
+  config.no_use_second_dragger = TRUE;
+  ASSERT_EQ(range_slider_rebind(w, &config), RET_OK);
+  ASSERT_EQ(count, 0u);
+  ASSERT_EQ(RANGE_SLIDER(w)->min, -50);
+  ASSERT_EQ(RANGE_SLIDER(w)->value1, -10);
+  ASSERT_EQ(RANGE_SLIDER(w)->value2, 30);
+  ASSERT_EQ(RANGE_SLIDER(w)->no_use_second_dragger, TRUE);
+
+  ASSERT_EQ(range_slider_reset(w), RET_OK);
+  ASSERT_EQ(count, 0u);
+  ASSERT_EQ(RANGE_SLIDER(w)->min, 0);
+  ASSERT_EQ(RANGE_SLIDER(w)->max, 100);
+  ASSERT_EQ(RANGE_SLIDER(w)->value1, 20);
+  ASSERT_EQ(RANGE_SLIDER(w)->value2, 50);
+  ASSERT_EQ(RANGE_SLIDER(w)->no_use_second_dragger, FALSE);
+
+  widget_destroy(w);
+}
+
+TEST(range_slider, load_phase_deferred) {
+  value_t v;
+  uint32_t count = 0;
+  widget_t* w = range_slider_create(NULL, 10, 20, 300, 40);
+
+  for (uint32_t type = EVT_VALUE1_WILL_CHANGE; type <= EVT_VALUE2_CHANGED; type++) {
+    widget_on(w, type, on_value_event_count, &count);
+  }
+
+  /* 模拟加载xml：value先于max到达 */
+  w->loading = TRUE;
+  value_set_double(&v, 500);
+  ASSERT_EQ(widget_set_prop(w, RANGE_SLIDER_PROP_VALUE1, &v), RET_OK);
+  value_set_double(&v, 900);
+  ASSERT_EQ(widget_set_prop(w, RANGE_SLIDER_PROP_VALUE2, &v), RET_OK);
+  value_set_double(&v, 1000);
+  ASSERT_EQ(widget_set_prop(w, WIDGET_PROP_MAX, &v), RET_OK);
+  widget_set_prop_bool(w, RANGE_SLIDER_PROP_NO_USE_SECOND_DRAGGER, FALSE);
+  widget_set_prop_str(w, RANGE_SLIDER_PROP_DRAGGER_STYLE, "no_dragger");
+  ASSERT_EQ(RANGE_SLIDER(w)->config_pending, TRUE);
+  w->loading = FALSE;
+
+  ASSERT_EQ(w->vt->on_layout_children(w), RET_OK);
+  ASSERT_EQ(count, 0u);
+  ASSERT_EQ(RANGE_SLIDER(w)->config_pending, FALSE);
+  ASSERT_EQ(RANGE_SLIDER(w)->value1, 500);
+  ASSERT_EQ(RANGE_SLIDER(w)->value2, 900);
+  ASSERT_STREQ(RANGE_SLIDER(w)->dragger_style, "no_dragger");
+  ASSERT_TRUE(RANGE_SLIDER(w)->dragger2 != NULL);
+
+  widget_destroy(w);
+}
+
+TEST(range_slider, config_str) {
+  widget_t* w = range_slider_create(NULL, 10, 20, 300, 40);
+
+  ASSERT_EQ(widget_set_prop_str(w, RANGE_SLIDER_PROP_CONFIG,
+                                "min=-100; max=100;value1=-20;value2=60;"
+                                "no_use_second_dragger=true;dragger_style=no_dragger"),
+            RET_OK);
+  ASSERT_EQ(RANGE_SLIDER(w)->min, -100);
+  ASSERT_EQ(RANGE_SLIDER(w)->max, 100);
+  ASSERT_EQ(RANGE_SLIDER(w)->value1, -20);
+  ASSERT_EQ(RANGE_SLIDER(w)->value2, 60);
+  ASSERT_EQ(RANGE_SLIDER(w)->no_use_second_dragger, TRUE);
+  ASSERT_STREQ(RANGE_SLIDER(w)->dragger_style, "no_dragger");
+
+  /* 一次钳位 */
+  ASSERT_EQ(widget_set_prop_str(w, RANGE_SLIDER_PROP_CONFIG, "max=50"), RET_OK);
+  ASSERT_EQ(RANGE_SLIDER(w)->value2, 50);
+  ASSERT_EQ(widget_set_prop_str(w, RANGE_SLIDER_PROP_CONFIG, "unknown=1"), RET_NOT_FOUND);
+
+  widget_destroy(w);
+}
+
+TEST(range_slider, config_snap) {
+  static const double s_e12[] = {10, 12, 15, 18, 22, 27, 33, 39, 47, 56, 68, 82};
+  widget_t* w = range_slider_create(NULL, 10, 20, 300, 40);
+
+  /* 与其它设置值的途径一样按step取整，两个值至少相隔一个step */
+  ASSERT_EQ(widget_set_prop_str(w, RANGE_SLIDER_PROP_CONFIG,
+                                "min=0;max=100;step=5;value1=12;value2=12"),
+            RET_OK);
+  ASSERT_RANGE(w, 5, 10);
+  ASSERT_EQ(widget_set_prop_str(w, RANGE_SLIDER_PROP_CONFIG, "value1=0;value2=0"), RET_OK);
+  ASSERT_RANGE(w, 0, 5);
+
+  /* 有允许值时取整到允许值 */
+  ASSERT_EQ(range_slider_set_allowed_values(w, s_e12, ARRAY_SIZE(s_e12)), RET_OK);
+  ASSERT_EQ(widget_set_prop_str(w, RANGE_SLIDER_PROP_CONFIG, "value1=34;value2=35"), RET_OK);
+  ASSERT_RANGE(w, 27, 33);
+
+  widget_destroy(w);
+}
+
+static ret_t on_range_changed(void* ctx, event_t* e) {
+  range_slider_range_event_t* evt = range_slider_range_event_cast(e);
+  range_slider_range_event_t* last = (range_slider_range_event_t*)ctx;
+  if (evt != NULL) {
+    *last = *evt;
+  }
+  return RET_OK;
+}
+
+TEST(range_slider, range_changed_event) {
+  value_t v;
+  range_slider_range_event_t last;
+  widget_t* w = range_slider_create(NULL, 10, 20, 300, 40);
+
+  memset(&last, 0x00, sizeof(last));
+  widget_on(w, EVT_RANGE_CHANGED, on_range_changed, &last);
+
+  value_set_double(&v, 0.5);
+  widget_set_prop(w, WIDGET_PROP_STEP, &v);
+  value_set_double(&v, 60.5);
+  ASSERT_EQ(widget_set_prop(w, RANGE_SLIDER_PROP_VALUE2, &v), RET_OK);
+  ASSERT_EQ(last.e.type, (uint32_t)EVT_RANGE_CHANGED);
+  ASSERT_EQ(last.dragger, 1u);
+  ASSERT_EQ(last.phase, RANGE_SLIDER_PHASE_CHANGED);
+  ASSERT_EQ(last.old_value, 50);
+  ASSERT_EQ(last.new_value, 60.5);
+  ASSERT_EQ(last.value1, 20);
+  ASSERT_EQ(last.value2, 60.5);
+
+  widget_destroy(w);
+}
+
+TEST(range_slider, key_state_machine) {
+  key_event_t e;
+  uint32_t key_count = 0;
+  uint32_t changed_count = 0;
+  widget_t* w = range_slider_create(NULL, 10, 20, 300, 40);
+  range_slider_t* range_slider = RANGE_SLIDER(w);
+  widget_t* dragger1 = range_slider->dragger1;
+
+  widget_on(w, EVT_KEY_DOWN, on_value_event_count, &key_count);
+  widget_on(w, EVT_VALUE1_CHANGED, on_value_event_count, &changed_count);
+  ASSERT_EQ(range_slider->input_state, RANGE_SLIDER_INPUT_IDLE);
+
+  /* 未选中时方向键不处理，交给焦点切换 */
+  key_event_init(&e, EVT_KEY_DOWN, dragger1, TK_KEY_RIGHT);
+  ASSERT_EQ(widget_dispatch(dragger1, (event_t*)&e), RET_OK);
+  ASSERT_EQ(range_slider->value1, 20);
+
+  /* 选中后每次按键只处理一次，不再转发给range_slider */
+  widget_set_prop_bool(dragger1, WIDGET_PROP_VALUE, TRUE);
+  ASSERT_EQ(range_slider->input_state, RANGE_SLIDER_INPUT_GRABBED);
+  ASSERT_EQ(range_slider->active_dragger, 0u);
+  ASSERT_EQ(widget_dispatch(dragger1, (event_t*)&e), RET_STOP);
+  ASSERT_EQ(range_slider->value1, 21);
+  ASSERT_EQ(changed_count, 1u);
+  ASSERT_EQ(key_count, 0u);
+
+  key_event_init(&e, EVT_KEY_DOWN, dragger1, TK_KEY_ESCAPE);
+  ASSERT_EQ(widget_dispatch(dragger1, (event_t*)&e), RET_STOP);
+  ASSERT_NE(range_slider->input_state, RANGE_SLIDER_INPUT_GRABBED);
+  ASSERT_EQ(key_count, 0u);
+
+  /* 未选中且没有放大时+/-留给父控件和应用的快捷键 */
+  key_event_init(&e, EVT_KEY_DOWN, dragger1, TK_KEY_PLUS);
+  ASSERT_EQ(widget_dispatch(dragger1, (event_t*)&e), RET_OK);
+  ASSERT_EQ(range_slider->view_span, 0);
+
+  /* 选中时缩放 */
+  widget_set_prop_bool(dragger1, WIDGET_PROP_VALUE, TRUE);
+  ASSERT_EQ(widget_dispatch(dragger1, (event_t*)&e), RET_STOP);
+  ASSERT_TRUE(range_slider->view_span > 0);
+
+  /* 已放大时未选中也可以继续缩放 */
+  key_event_init(&e, EVT_KEY_DOWN, dragger1, TK_KEY_ESCAPE);
+  widget_dispatch(dragger1, (event_t*)&e);
+  key_event_init(&e, EVT_KEY_DOWN, dragger1, TK_KEY_MINUS);
+  ASSERT_EQ(widget_dispatch(dragger1, (event_t*)&e), RET_STOP);
+  ASSERT_EQ(range_slider->view_span, 0);
+  ASSERT_EQ(widget_dispatch(dragger1, (event_t*)&e), RET_OK);
+
+  widget_destroy(w);
+}
+
+TEST(range_slider, allowed_values) {
+  key_event_t e;
+  /* E12系列 */
+  static const double s_e12[] = {10, 12, 15, 18, 22, 27, 33, 39, 47, 56, 68, 82};
+  widget_t* w = range_slider_create(NULL, 10, 20, 300, 40);
+  widget_t* other = range_slider_create(NULL, 10, 80, 300, 40);
+  range_slider_t* range_slider = RANGE_SLIDER(w);
+
+  /* 关联时当前值取整到最近的允许值，距离相等时取较小的 */
+  ASSERT_EQ(range_slider_set_allowed_values(w, s_e12, ARRAY_SIZE(s_e12)), RET_OK);
+  ASSERT_EQ(range_slider->value1, 18);
+  ASSERT_EQ(range_slider->value2, 47);
+
+  widget_set_prop_double(w, RANGE_SLIDER_PROP_VALUE1, 30);
+  ASSERT_EQ(range_slider->value1, 27);
+  widget_set_prop_double(w, RANGE_SLIDER_PROP_VALUE2, 1000);
+  ASSERT_EQ(range_slider->value2, 82);
+  widget_set_prop_double(w, RANGE_SLIDER_PROP_VALUE2, 47);
+
+  /* 防碰撞取相邻的允许值 */
+  widget_set_prop_double(w, RANGE_SLIDER_PROP_VALUE1, 60);
+  ASSERT_EQ(range_slider->value1, 39);
+
+  /* 键盘增减取相邻的允许值 */
+  widget_set_prop_bool(range_slider->dragger1, WIDGET_PROP_VALUE, TRUE);
+  key_event_init(&e, EVT_KEY_DOWN, range_slider->dragger1, TK_KEY_LEFT);
+  widget_dispatch(range_slider->dragger1, (event_t*)&e);
+  ASSERT_EQ(range_slider->value1, 33);
+  widget_dispatch(range_slider->dragger1, (event_t*)&e);
+  ASSERT_EQ(range_slider->value1, 27);
+
+  /* 多个控件共享同一个数组，不拷贝 */
+  ASSERT_EQ(range_slider_set_allowed_values(other, s_e12, ARRAY_SIZE(s_e12)), RET_OK);
+  ASSERT_TRUE(RANGE_SLIDER(other)->allowed_values == range_slider->allowed_values);
+
+  /* 解除关联后恢复按step取整 */
+  ASSERT_EQ(range_slider_set_allowed_values(w, NULL, 0), RET_OK);
+  widget_set_prop_double(w, RANGE_SLIDER_PROP_VALUE1, 30.5);
+  ASSERT_EQ(range_slider->value1, 30.5);
+
+  widget_destroy(w);
+  widget_destroy(other);
+}
+
+static ret_t touch_at(widget_t* w, uint32_t type, int64_t finger_id, xy_t x) {
+  touch_event_t e;
+  point_t p = {x, 5};
+  system_info_t* info = system_info();
+
+  widget_to_global(RANGE_SLIDER(w)->view, &p);
+  touch_event_init(&e, type, w, 0, finger_id, (p.x + 0.5f) / info->lcd_w,
+                   (p.y + 0.5f) / info->lcd_h, 1);
+
+  return widget_dispatch(w, (event_t*)&e);
+}
+
+TEST(range_slider, multi_touch) {
+  uint32_t range_count = 0;
+  uint32_t changed_count = 0;
+  range_slider_config_t config;
+  system_info_t* info = system_info();
+  widget_t* w = range_slider_create(NULL, 10, 20, 300, 40);
+  range_slider_t* range_slider = RANGE_SLIDER(w);
+
+  if (info->lcd_w == 0 || info->lcd_h == 0) {
+    info->lcd_w = 800;
+    info->lcd_h = 480;
+  }
+  range_slider_get_config(w, &config);
+  config.range_slider_view_width_ratio = 1;
+  config.range_slider_view_height_ratio = 1;
+  config.step = 1;
+  range_slider_configure(w, &config);
+  widget_layout(w);
+  widget_on(w, EVT_RANGE_CHANGED, on_value_event_count, &range_count);
+  widget_on(w, EVT_VALUE1_CHANGED, on_value_event_count, &changed_count);
+  widget_on(w, EVT_VALUE2_CHANGED, on_value_event_count, &changed_count);
+
+  /* 两个手指分别按住两个滑块 */
+  ASSERT_EQ(touch_at(w, EVT_TOUCH_DOWN, 1, 60), RET_STOP);
+  ASSERT_EQ(touch_at(w, EVT_TOUCH_DOWN, 2, 150), RET_STOP);
+  ASSERT_TRUE(range_slider->touches[0].active && range_slider->touches[1].active);
+  range_count = 0;
+
+  /* 同一帧内的两次移动合并为一次更新 */
+  touch_at(w, EVT_TOUCH_MOVE, 1, 30);
+  touch_at(w, EVT_TOUCH_MOVE, 2, 270);
+  ASSERT_EQ(range_slider->value1, 20);
+  ASSERT_EQ(range_slider->value2, 50);
+  idle_dispatch();
+  ASSERT_EQ(range_count, 1u);
+  ASSERT_LT(range_slider->value1, 20);
+  ASSERT_GT(range_slider->value2, 50);
+
+  /* 交叉时停在另一个滑块旁边 */
+  touch_at(w, EVT_TOUCH_MOVE, 1, 299);
+  idle_dispatch();
+  ASSERT_EQ(range_slider->value1, range_slider->value2 - 1);
+
+  touch_at(w, EVT_TOUCH_UP, 1, 299);
+  touch_at(w, EVT_TOUCH_UP, 2, 270);
+  ASSERT_EQ(changed_count, 2u);
+  ASSERT_FALSE(range_slider->touches[0].active || range_slider->touches[1].active);
+
+  widget_destroy(w);
+}
+
+TEST(range_slider, shared_touch_listener) {
+  touch_event_t e;
+  point_t p = {60, 5};
+  uint32_t nr = 0;
+  range_slider_config_t config;
+  system_info_t* info = system_info();
+  widget_t* wm = window_manager();
+  widget_t* win = NULL;
+  widget_t* w = NULL;
+  widget_t* idle = NULL;
+
+  if (wm == NULL) {
+    GTEST_SKIP();
+  }
+  if (info->lcd_w == 0 || info->lcd_h == 0) {
+    info->lcd_w = 800;
+    info->lcd_h = 480;
+  }
+  win = window_create(NULL, 0, 0, 400, 40);
+  w = range_slider_create(win, 10, 0, 300, 40);
+  range_slider_get_config(w, &config);
+  config.range_slider_view_width_ratio = 1;
+  config.range_slider_view_height_ratio = 1;
+  range_slider_configure(w, &config);
+  widget_layout(w);
+  ASSERT_TRUE(wm->emitter != NULL);
+  nr = emitter_size(wm->emitter);
+
+  /* 再多的控件也只有一个EVT_TOUCH_DOWN监听 */
+  idle = range_slider_create(NULL, 0, 0, 300, 40);
+  ASSERT_EQ(emitter_size(wm->emitter), nr);
+  widget_destroy(idle);
+  ASSERT_EQ(emitter_size(wm->emitter), nr);
+
+  if (window_manager_get_top_window(wm) != win) {
+    widget_destroy(win);
+    GTEST_SKIP();
+  }
+
+  /* 按住滑块后才监听移动和抬起，抬起后移除 */
+  widget_to_global(RANGE_SLIDER(w)->view, &p);
+  touch_event_init(&e, EVT_TOUCH_DOWN, wm, 0, 1, (p.x + 0.5f) / info->lcd_w,
+                   (p.y + 0.5f) / info->lcd_h, 1);
+  widget_dispatch(wm, (event_t*)&e);
+  ASSERT_TRUE(RANGE_SLIDER(w)->touches[0].active);
+  ASSERT_EQ(emitter_size(wm->emitter), nr + 2);
+
+  touch_event_init(&e, EVT_TOUCH_UP, wm, 0, 1, (p.x + 0.5f) / info->lcd_w,
+                   (p.y + 0.5f) / info->lcd_h, 1);
+  widget_dispatch(wm, (event_t*)&e);
+  ASSERT_FALSE(RANGE_SLIDER(w)->touches[0].active);
+  ASSERT_EQ(emitter_size(wm->emitter), nr);
+
+  widget_destroy(win);
+}
+
+TEST(range_slider, pool_no_heap_after_reserve) {
+  uint32_t i = 0;
+  uint32_t round = 0;
+  widget_t* sliders[4] = {NULL};
+  widget_t* parent = view_create(NULL, 0, 0, 320, 480);
+  range_slider_pool_t* pool = range_slider_pool_create(ARRAY_SIZE(sliders));
+  ASSERT_TRUE(pool != NULL);
+
+  /* 第一轮让父控件的children和label的文本缓冲区增长到位 */
+  for (i = 0; i < ARRAY_SIZE(sliders); i++) {
+    sliders[i] = range_slider_pool_acquire(pool, parent, 0, i * 50, 300, 40);
+    ASSERT_TRUE(sliders[i] != NULL);
+  }
+  /* 池空时不会退化为堆分配 */
+  ASSERT_TRUE(range_slider_pool_acquire(pool, parent, 0, 0, 300, 40) == NULL);
+  widget_layout(parent);
+  for (i = 0; i < ARRAY_SIZE(sliders); i++) {
+    ASSERT_EQ(range_slider_pool_release(pool, sliders[i]), RET_OK);
+  }
+  ASSERT_EQ(widget_count_children(parent), 0);
+
+  if (alloc_counter_supported()) {
+    alloc_counter_start();
+    for (round = 0; round < 1000; round++) {
+      for (i = 0; i < ARRAY_SIZE(sliders); i++) {
+        sliders[i] = range_slider_pool_acquire(pool, parent, 0, i * 50, 300, 40);
+      }
+      /* 切换为单滑块只隐藏dragger2，恢复时重新显示 */
+      widget_set_prop_bool(sliders[1], RANGE_SLIDER_PROP_NO_USE_SECOND_DRAGGER, TRUE);
+      widget_set_prop_double(sliders[2], RANGE_SLIDER_PROP_VALUE1, round % 50);
+      widget_layout(parent);
+      for (i = 0; i < ARRAY_SIZE(sliders); i++) {
+        range_slider_pool_release(pool, sliders[i]);
+      }
+    }
+    ASSERT_EQ(alloc_counter_stop(), 0u);
+    ASSERT_EQ(alloc_counter_peak_bytes(), 0);
+  }
+
+  /* 归还后恢复为缺省状态 */
+  sliders[0] = range_slider_pool_acquire(pool, parent, 0, 0, 300, 40);
+  ASSERT_EQ(RANGE_SLIDER(sliders[0])->no_use_second_dragger, FALSE);
+  ASSERT_EQ(RANGE_SLIDER(sliders[0])->value1, 20);
+
+  /* 重复归还不会让空闲栈中出现两次同一个控件 */
+  ASSERT_EQ(range_slider_pool_release(pool, sliders[0]), RET_OK);
+  ASSERT_EQ(range_slider_pool_release(pool, sliders[0]), RET_BAD_PARAMS);
+  ASSERT_EQ(pool->free_nr, pool->capacity);
+
+  /* 随父控件一起销毁或被直接销毁的控件回到池中，反复重建界面不会耗尽容量 */
+  for (round = 0; round < 3; round++) {
+    for (i = 0; i < ARRAY_SIZE(sliders); i++) {
+      sliders[i] = range_slider_pool_acquire(pool, parent, 0, i * 50, 300, 40);
+      ASSERT_TRUE(sliders[i] != NULL);
+    }
+    widget_set_prop_double(sliders[0], RANGE_SLIDER_PROP_VALUE1, 30);
+    widget_destroy(sliders[1]);
+    widget_destroy(parent);
+    ASSERT_EQ(range_slider_pool_collect(pool), pool->capacity);
+    ASSERT_EQ(pool->free_nr, pool->capacity);
+    parent = view_create(NULL, 0, 0, 320, 480);
+  }
+  sliders[0] = range_slider_pool_acquire(pool, parent, 0, 0, 300, 40);
+  ASSERT_EQ(RANGE_SLIDER(sliders[0])->value1, 20);
+  ASSERT_TRUE(sliders[0]->parent == parent);
+
+  widget_destroy(parent);
+  range_slider_pool_destroy(pool);
+}
+
+static ret_t on_range_count(void* ctx, event_t* e) {
+  (*(uint32_t*)ctx)++;
+  return RET_OK;
+}
+
+TEST(range_slider, pool_release_clears_listeners) {
+  uint32_t count = 0;
+  widget_t* parent = view_create(NULL, 0, 0, 320, 480);
+  range_slider_pool_t* pool = range_slider_pool_create(1);
+  range_slider_group_t* group = range_slider_group_create(RANGE_SLIDER_GROUP_NO_OVERLAP, 2);
+  widget_t* w = range_slider_pool_acquire(pool, parent, 0, 0, 300, 40);
+
+  widget_on(w, EVT_RANGE_CHANGED, on_range_count, &count);
+  ASSERT_EQ(range_slider_group_add(group, w), RET_OK);
+  widget_set_prop_double(w, RANGE_SLIDER_PROP_VALUE1, 30);
+  ASSERT_EQ(count, 1u);
+
+  /* 上一个使用者的处理函数和组成员关系在归还时清除 */
+  ASSERT_EQ(range_slider_pool_release(pool, w), RET_OK);
+  ASSERT_EQ(group->nr, 0u);
+  w = range_slider_pool_acquire(pool, parent, 0, 0, 300, 40);
+  widget_set_prop_double(w, RANGE_SLIDER_PROP_VALUE1, 30);
+  ASSERT_EQ(count, 1u);
+
+  /* 随父控件销毁后回收的也一样 */
+  widget_on(w, EVT_RANGE_CHANGED, on_range_count, &count);
+  widget_destroy(parent);
+  ASSERT_EQ(range_slider_pool_collect(pool), 1u);
+  parent = view_create(NULL, 0, 0, 320, 480);
+  w = range_slider_pool_acquire(pool, parent, 0, 0, 300, 40);
+  widget_set_prop_double(w, RANGE_SLIDER_PROP_VALUE1, 40);
+  ASSERT_EQ(count, 1u);
+
+  widget_destroy(parent);
+  range_slider_group_destroy(group);
+  range_slider_pool_destroy(pool);
+}
+
+static ret_t on_range_set_other(void* ctx, event_t* e) {
+  widget_set_prop_double(WIDGET(ctx), RANGE_SLIDER_PROP_VALUE2, 99);
+  return RET_OK;
+}
+
+static range_slider_group_t* group_create(range_slider_group_rule_t rule, widget_t** w,
+                                          uint32_t* counts) {
+  uint32_t i = 0;
+  range_slider_group_t* group = range_slider_group_create(rule, 3);
+
+  for (i = 0; i < 3; i++) {
+    w[i] = range_slider_create(NULL, 0, i * 50, 300, 40);
+    range_slider_set_range(w[i], 10 + i * 30, 30 + i * 30, FALSE);
+    range_slider_group_add(group, w[i]);
+    counts[i] = 0;
+    widget_on(w[i], EVT_RANGE_CHANGED, on_range_count, counts + i);
+  }
+
+  return group;
+}
+
+TEST(range_slider, group) {
+  uint32_t i = 0;
+  widget_t* w[3];
+  uint32_t counts[3];
+  range_slider_group_t* group = group_create(RANGE_SLIDER_GROUP_NO_OVERLAP, w, counts);
+  range_slider_group_set_gap(group, 5);
+
+  /* 推开右侧的成员，每个改变的成员只收到一次事件 */
+  widget_set_prop_double(w[0], RANGE_SLIDER_PROP_VALUE2, 50);
+  ASSERT_RANGE(w[0], 10, 50);
+  ASSERT_RANGE(w[1], 55, 75);
+  ASSERT_RANGE(w[2], 80, 100);
+  ASSERT_EQ(counts[0], 1u);
+  ASSERT_EQ(counts[1], 1u);
+  ASSERT_EQ(counts[2], 1u);
+
+  /* 推不动时压回来，连源成员也被限制 */
+  widget_set_prop_double(w[0], RANGE_SLIDER_PROP_VALUE2, 95);
+  ASSERT_RANGE(w[0], 10, 90);
+  ASSERT_RANGE(w[1], 95, 95);
+  ASSERT_RANGE(w[2], 100, 100);
+
+  /* 事件处理函数中修改其它成员不会重入，通知完成后再求解，约束仍然成立 */
+  widget_on(w[1], EVT_RANGE_CHANGED, on_range_set_other, w[0]);
+  widget_set_prop_double(w[2], RANGE_SLIDER_PROP_VALUE1, 70);
+  ASSERT_FALSE(group->resolving);
+  ASSERT_EQ(group->deferred, -1);
+  for (i = 0; i + 1 < 3; i++) {
+    ASSERT_LE(RANGE_SLIDER(w[i])->value2 + 5, RANGE_SLIDER(w[i + 1])->value1);
+  }
+
+  /* 成员销毁时自动移除 */
+  widget_destroy(w[1]);
+  ASSERT_EQ(group->nr, 2u);
+  widget_destroy(w[0]);
+  widget_destroy(w[2]);
+  ASSERT_EQ(group->nr, 0u);
+  range_slider_group_destroy(group);
+
+  group = group_create(RANGE_SLIDER_GROUP_FIXED_GAP, w, counts);
+  range_slider_group_set_gap(group, 10);
+  widget_set_prop_double(w[1], RANGE_SLIDER_PROP_VALUE1, 45);
+  ASSERT_RANGE(w[0], 10, 35);
+  ASSERT_RANGE(w[1], 45, 60);
+  ASSERT_RANGE(w[2], 70, 90);
+  ASSERT_EQ(counts[0], 1u);
+  ASSERT_EQ(counts[2], 0u);
+  range_slider_group_destroy(group);
+  for (i = 0; i < 3; i++) {
+    widget_destroy(w[i]);
+  }
+
+  group = group_create(RANGE_SLIDER_GROUP_SHARED_TOTAL, w, counts);
+  range_slider_group_set_total(group, 60);
+  widget_set_prop_double(w[0], RANGE_SLIDER_PROP_VALUE2, 40);
+  ASSERT_RANGE(w[0], 10, 40);
+  ASSERT_RANGE(w[1], 40, 55);
+  ASSERT_RANGE(w[2], 70, 85);
+  range_slider_group_destroy(group);
+  for (i = 0; i < 3; i++) {
+    widget_destroy(w[i]);
+  }
+}
+
+TEST(range_slider, follow_live_edge) {
+  uint32_t i = 0;
+  uint32_t changed = 0;
+  widget_t* w = range_slider_create(NULL, 10, 20, 300, 40);
+  range_slider_t* range_slider = RANGE_SLIDER(w);
+  widget_t* label_max = NULL;
+
+  ASSERT_EQ(w->vt->on_layout_children(w), RET_OK);
+  label_max = widget_lookup(w, RANGE_SLIDER_SUB_WIDGET_LABEL_MAX, TRUE);
+  ASSERT_TRUE(label_max != NULL);
+
+  /* 不跟随时立即钳位并更新范围label，不需要重新布局 */
+  widget_set_prop_double(w, WIDGET_PROP_MAX, 40);
+  ASSERT_EQ(range_slider->value2, 40);
+  ASSERT_EQ(wstr_eq(&(label_max->text), L"40"), TRUE);
+  ASSERT_EQ(range_slider->layout.max, 40);
+
+  widget_set_prop_bool(w, RANGE_SLIDER_PROP_FOLLOW, TRUE);
+  widget_on(w, EVT_RANGE_CHANGED, on_range_count, &changed);
+
+  /* 1kHz的采样在一帧内只应用一次，贴在max上的窗口平移 */
+  for (i = 1; i <= 1000; i++) {
+    widget_set_prop_double(w, WIDGET_PROP_MAX, 40 + i);
+  }
+  ASSERT_EQ(range_slider->max, 40);
+  ASSERT_EQ(widget_get_prop_int(w, WIDGET_PROP_MAX, 0), 1040);
+  idle_dispatch();
+  ASSERT_EQ(range_slider->max, 1040);
+  ASSERT_EQ(range_slider->value1, 1020);
+  ASSERT_EQ(range_slider->value2, 1040);
+  ASSERT_EQ(changed, 1u);
+  ASSERT_EQ(wstr_eq(&(label_max->text), L"1040"), TRUE);
+
+  /* 离开max的窗口保持不动 */
+  widget_set_prop_double(w, RANGE_SLIDER_PROP_VALUE2, 1030);
+  changed = 0;
+  widget_set_prop_double(w, WIDGET_PROP_MAX, 2000);
+  idle_dispatch();
+  ASSERT_EQ(range_slider->value1, 1020);
+  ASSERT_EQ(range_slider->value2, 1030);
+  ASSERT_EQ(changed, 0u);
+
+  /* 销毁时取消尚未应用的更新 */
+  widget_set_prop_double(w, WIDGET_PROP_MAX, 3000);
+  widget_destroy(w);
+  idle_dispatch();
+}
+
+TEST(range_slider, inverted_bounds) {
+  uint32_t changed = 0;
+  static const double s_e12[] = {10, 12, 15, 18, 22, 27, 33, 39, 47, 56, 68, 82};
+  widget_t* w = range_slider_create(NULL, 10, 20, 300, 40);
+  range_slider_t* range_slider = RANGE_SLIDER(w);
+
+  widget_on(w, EVT_RANGE_CHANGED, on_range_count, &changed);
+
+  /* 先设min再设max时，中间颠倒的范围不应用，选中的区间不会被钳到min上 */
+  widget_set_prop_double(w, WIDGET_PROP_MIN, 200);
+  ASSERT_EQ(range_slider->min, 0);
+  ASSERT_RANGE(w, 20, 50);
+  ASSERT_EQ(widget_get_prop_int(w, WIDGET_PROP_MIN, 0), 200);
+  widget_set_prop_double(w, WIDGET_PROP_MAX, 1000);
+  ASSERT_EQ(range_slider->min, 200);
+  ASSERT_EQ(range_slider->max, 1000);
+  ASSERT_EQ(changed, 1u);
+  idle_dispatch();
+  ASSERT_EQ(range_slider->min, 200);
+
+  /* 到下一帧仍然颠倒时放弃 */
+  range_slider_set_range(w, 300, 500, FALSE);
+  changed = 0;
+  ASSERT_EQ(range_slider_set_bounds(w, 2000, 1000), RET_OK);
+  idle_dispatch();
+  ASSERT_EQ(range_slider->min, 200);
+  ASSERT_EQ(range_slider->max, 1000);
+  ASSERT_RANGE(w, 300, 500);
+  ASSERT_EQ(changed, 0u);
+
+  /* 关闭跟随模式时立即应用记下的范围，颠倒的同样丢弃 */
+  widget_set_prop_bool(w, RANGE_SLIDER_PROP_FOLLOW, TRUE);
+  ASSERT_EQ(range_slider_set_bounds(w, 2000, 1000), RET_OK);
+  widget_set_prop_bool(w, RANGE_SLIDER_PROP_FOLLOW, FALSE);
+  ASSERT_EQ(range_slider->bounds_idle_id, (uint32_t)TK_INVALID_ID);
+  ASSERT_EQ(range_slider->min, 200);
+  ASSERT_EQ(range_slider->max, 1000);
+  ASSERT_EQ(changed, 0u);
+
+  /* 钳位后的值按step取整，max不在step上时取不超过max的那一个 */
+  range_slider_set_bounds(w, 0, 100);
+  widget_set_prop_double(w, WIDGET_PROP_STEP, 10);
+  range_slider_set_range(w, 20, 50, FALSE);
+  range_slider_set_bounds(w, 0, 45);
+  ASSERT_RANGE(w, 20, 40);
+
+  /* 有允许值时取整到范围内最近的允许值 */
+  range_slider_set_bounds(w, 0, 100);
+  range_slider_set_allowed_values(w, s_e12, ARRAY_SIZE(s_e12));
+  range_slider_set_range(w, 18, 47, FALSE);
+  range_slider_set_bounds(w, 0, 40);
+  ASSERT_RANGE(w, 18, 39);
+
+  widget_destroy(w);
+}
+
+TEST(range_slider, zoom_viewport) {
+  wheel_event_t e;
+  widget_t* w = range_slider_create(NULL, 10, 20, 300, 40);
+  range_slider_t* range_slider = RANGE_SLIDER(w);
+
+  widget_set_prop_double(w, WIDGET_PROP_MAX, 1e12);
+  ASSERT_EQ(range_slider_set_viewport(w, 5e11, 1000), RET_OK);
+  ASSERT_EQ(range_slider->view_start, 5e11);
+  ASSERT_EQ(range_slider->view_span, 1000);
+
+  /* 缩放中心在屏幕上的位置不变 */
+  ASSERT_EQ(range_slider_zoom(w, 2, 5e11 + 500), RET_OK);
+  ASSERT_EQ(range_slider->view_start, 5e11 + 250);
+  ASSERT_EQ(range_slider->view_span, 500);
+
+  /* 缩小到覆盖整个范围时取消缩放 */
+  ASSERT_EQ(range_slider_zoom(w, 1e-20, 5e11), RET_OK);
+  ASSERT_EQ(range_slider->view_span, 0);
+
+  /* 子区间限制在[min, max]之内 */
+  ASSERT_EQ(range_slider_set_viewport(w, -10, 100), RET_OK);
+  ASSERT_EQ(range_slider->view_start, 0);
+  ASSERT_EQ(range_slider->view_span, 100);
+
+  /* ctrl+滚轮以选中区间的中点为中心放大 */
+  range_slider_set_range(w, 20, 60, FALSE);
+  wheel_event_init(&e, EVT_WHEEL, w, 120);
+  e.ctrl = TRUE;
+  ASSERT_EQ(w->vt->on_event(w, (event_t*)&e), RET_STOP);
+  ASSERT_EQ(range_slider->view_span, 80);
+  ASSERT_EQ(range_slider->view_start, 8);
+
+  /* 范围缩小后子区间随之钳位 */
+  widget_set_prop_double(w, WIDGET_PROP_MAX, 50);
+  ASSERT_EQ(range_slider->view_span, 0);
+
+  range_slider_reset(w);
+  ASSERT_EQ(range_slider->overview_height, 4u);
+  widget_destroy(w);
+}
+
+static ret_t on_trace(void* ctx, const char* name, char phase, uint32_t arg, uint64_t ts_us) {
+  (*(uint32_t*)ctx)++;
+  return RET_OK;
+}
+
+TEST(range_slider, trace) {
+  str_t str;
+  uint32_t hooked = 0;
+  widget_t* w = NULL;
+
+  /* 未以RANGE_SLIDER_WITH_TRACE=1编译时跟踪函数都是空的 */
+  if (range_slider_trace_clear() == RET_NOT_IMPL) {
+    ASSERT_EQ(range_slider_trace_count(), 0u);
+    ASSERT_EQ(range_slider_trace_dump("range_slider_trace.json"), RET_NOT_IMPL);
+    GTEST_SKIP();
+  }
+
+  range_slider_trace_set_hook(on_trace, &hooked);
+  w = range_slider_create(NULL, 10, 20, 300, 40);
+  w->vt->on_layout_children(w);
+  widget_set_prop_double(w, RANGE_SLIDER_PROP_VALUE1, 30);
+  range_slider_trace_set_hook(NULL, NULL);
+
+  /* 布局和设置值各一对begin/end */
+  ASSERT_GE(range_slider_trace_count(), 4u);
+  ASSERT_EQ(hooked, range_slider_trace_count());
+
+  str_init(&str, 1024);
+  ASSERT_EQ(range_slider_trace_to_json(&str), RET_OK);
+  ASSERT_TRUE(strstr(str.str, "{\"traceEvents\":[") == str.str);
+  ASSERT_TRUE(strstr(str.str, "\"name\":\"" RANGE_SLIDER_TRACE_LAYOUT "\"") != NULL);
+  ASSERT_TRUE(strstr(str.str, "\"name\":\"" RANGE_SLIDER_TRACE_SET_VALUE "\"") != NULL);
+  ASSERT_TRUE(strstr(str.str, "\"ph\":\"E\"") != NULL);
+  str_reset(&str);
+
+  ASSERT_EQ(range_slider_trace_dump("range_slider_trace.json"), RET_OK);
+  range_slider_trace_clear();
+  ASSERT_EQ(range_slider_trace_count(), 0u);
+  widget_destroy(w);
+}
+
+static ret_t pointer_at(widget_t* w, uint32_t type, xy_t x) {
+  pointer_event_t e;
+  pointer_event_init(&e, type, w, x, 10);
+  return widget_dispatch(w, (event_t*)&e);
+}
+
+static ret_t key_on(widget_t* dragger, uint32_t key) {
+  key_event_t e;
+  key_event_init(&e, EVT_KEY_DOWN, dragger, key);
+  return widget_dispatch(dragger, (event_t*)&e);
+}
+
+TEST(range_slider, drag_no_alloc) {
+  uint32_t i = 0;
+  canvas_t c;
+  rect_t r = rect_init(0, 0, 300, 40);
+  uint8_t* fb = TKMEM_ZALLOCN(uint8_t, 300 * 40 * 4);
+  lcd_t* lcd = lcd_mem_bgra8888_create_single_fb(300, 40, fb);
+  widget_t* w = range_slider_create(NULL, 0, 0, 300, 40);
+  range_slider_t* range_slider = RANGE_SLIDER(w);
+  widget_t* dragger1 = range_slider->dragger1;
+  xy_t x = 0;
+
+  canvas_init(&c, lcd, font_manager());
+  canvas_begin_frame(&c, &r, LCD_DRAW_NORMAL);
+  widget_set_prop_double(w, WIDGET_PROP_STEP, 1);
+  widget_set_prop_float(w, RANGE_SLIDER_PROP_VIEW_WIDTH_RATIO, 0.8f);
+  widget_set_prop_float(w, RANGE_SLIDER_PROP_VIEW_HEIGHT_RATIO, 0.5f);
+  widget_layout(w);
+  widget_paint(w, &c);
+
+  /* 先完整拖动一遍，让字形缓存等一次性的资源加载到位 */
+  x = dragger1->x + dragger1->w / 2 + range_slider->view->x;
+  ASSERT_EQ(pointer_at(w, EVT_POINTER_DOWN, x), RET_OK);
+  ASSERT_EQ(range_slider->input_state, RANGE_SLIDER_INPUT_DRAGGING);
+  for (x = 0; x < 300; x += 3) {
+    pointer_at(w, EVT_POINTER_MOVE, x);
+    widget_paint(w, &c);
+  }
+  pointer_at(w, EVT_POINTER_MOVE, 0);
+  widget_paint(w, &c);
+  pointer_at(w, EVT_POINTER_UP, 0);
+  widget_paint(w, &c);
+  widget_set_prop_bool(dragger1, WIDGET_PROP_VALUE, FALSE);
+
+  if (!alloc_counter_supported()) {
+    canvas_end_frame(&c);
+    widget_destroy(w);
+    lcd_destroy(lcd);
+    TKMEM_FREE(fb);
+    GTEST_SKIP();
+  }
+
+  alloc_counter_start();
+  x = dragger1->x + dragger1->w / 2 + range_slider->view->x;
+  pointer_at(w, EVT_POINTER_DOWN, x);
+  for (i = 0; i < 1000; i++) {
+    pointer_at(w, EVT_POINTER_MOVE, (i * 7) % 300);
+    widget_paint(w, &c);
+  }
+  pointer_at(w, EVT_POINTER_UP, 150);
+  widget_paint(w, &c);
+
+  /* 键盘选中滑块后左右调整值，同样不分配内存 */
+  widget_set_prop_bool(dragger1, WIDGET_PROP_VALUE, TRUE);
+  for (i = 0; i < 1000; i++) {
+    key_on(dragger1, (i / 10) % 2 ? TK_KEY_LEFT : TK_KEY_RIGHT);
+    widget_paint(w, &c);
+  }
+  ASSERT_EQ(alloc_counter_stop(), 0u);
+  ASSERT_EQ(range_slider->input_state, RANGE_SLIDER_INPUT_GRABBED);
+
+  canvas_end_frame(&c);
+  widget_destroy(w);
+  lcd_destroy(lcd);
+  TKMEM_FREE(fb);
+}
+
+TEST(range_slider, paint_clip_early_out) {
+  canvas_t c;
+  rect_t r = rect_init(0, 0, 300, 200);
+  uint8_t* fb = TKMEM_ZALLOCN(uint8_t, 300 * 200 * 4);
+  lcd_t* lcd = lcd_mem_bgra8888_create_single_fb(300, 200, fb);
+  widget_t* w = range_slider_create(NULL, 0, 0, 300, 40);
+  range_slider_t* range_slider = RANGE_SLIDER(w);
+
+  canvas_init(&c, lcd, font_manager());
+  canvas_begin_frame(&c, &r, LCD_DRAW_NORMAL);
+  widget_set_prop_float(w, RANGE_SLIDER_PROP_VIEW_WIDTH_RATIO, 0.8f);
+  widget_set_prop_float(w, RANGE_SLIDER_PROP_VIEW_HEIGHT_RATIO, 0.5f);
+  widget_layout(w);
+
+  /* 脏矩形在控件之外(如滚动视图中移出可视区)，什么都不做 */
+  range_slider->track_draw_calls = 99;
+  r = rect_init(0, 100, 300, 50);
+  canvas_set_clip_rect(&c, &r);
+  ASSERT_EQ(w->vt->on_paint_self(w, &c), RET_OK);
+  ASSERT_EQ(range_slider->track_draw_calls, 99u);
+
+  /* 只波及到滑轨下方的值label，不重绘滑轨 */
+  r = rect_init(0, 30, 300, 10);
+  canvas_set_clip_rect(&c, &r);
+  ASSERT_EQ(w->vt->on_paint_self(w, &c), RET_OK);
+  ASSERT_EQ(range_slider->track_draw_calls, 0u);
+
+  r = rect_init(0, 0, 300, 40);
+  canvas_set_clip_rect(&c, &r);
+  ASSERT_EQ(w->vt->on_paint_self(w, &c), RET_OK);
+  ASSERT_GT(range_slider->track_draw_calls, 0u);
+
+  canvas_end_frame(&c);
+  widget_destroy(w);
+  lcd_destroy(lcd);
+  TKMEM_FREE(fb);
+}
+
+TEST(range_slider, state_snapshot) {
+  wbuffer_t wb;
+  rbuffer_t rb;
+  uint32_t i = 0;
+  uint32_t count = 0;
+  widget_t* w[3];
+  widget_t* parent = view_create(NULL, 0, 0, 320, 480);
+  widget_t* other = range_slider_create(NULL, 0, 0, 300, 40);
+  widget_t* extra = NULL;
+
+  for (i = 0; i < 3; i++) {
+    w[i] = range_slider_create(parent, 0, i * 40, 300, 40);
+    range_slider_set_bounds(w[i], 0, 1000);
+    range_slider_set_range(w[i], 10 * i, 500 + 10 * i, FALSE);
+  }
+  range_slider_set_viewport(w[1], 100, 200);
+  widget_set_prop_bool(w[2], RANGE_SLIDER_PROP_FOLLOW, TRUE);
+
+  wbuffer_init_extendable(&wb);
+  ASSERT_EQ(range_slider_save_state(w[1], &wb), RET_OK);
+  rbuffer_init(&rb, wb.data, wb.cursor);
+  widget_on(other, EVT_RANGE_CHANGED, on_range_count, &count);
+  ASSERT_EQ(range_slider_load_state(other, &rb), RET_OK);
+  ASSERT_FALSE(rbuffer_has_more(&rb));
+  ASSERT_RANGE(other, 10, 510);
+  ASSERT_EQ(RANGE_SLIDER(other)->max, 1000);
+  ASSERT_EQ(RANGE_SLIDER(other)->view_start, 100);
+  ASSERT_EQ(RANGE_SLIDER(other)->view_span, 200);
+  ASSERT_EQ(count, 1u);
+
+  /* 数据被截断或不合法时不做任何修改 */
+  rbuffer_init(&rb, wb.data, wb.cursor - 1);
+  ASSERT_NE(range_slider_load_state(w[0], &rb), RET_OK);
+  ASSERT_RANGE(w[0], 0, 500);
+  wbuffer_deinit(&wb);
+
+  wbuffer_init_extendable(&wb);
+  ASSERT_EQ(range_slider_save_states(parent, &wb), RET_OK);
+  for (i = 0; i < 3; i++) {
+    range_slider_reset(w[i]);
+  }
+  ASSERT_FALSE(RANGE_SLIDER(w[2])->follow);
+  rbuffer_init(&rb, wb.data, wb.cursor);
+  ASSERT_EQ(range_slider_load_states(parent, &rb), RET_OK);
+  for (i = 0; i < 3; i++) {
+    ASSERT_RANGE(w[i], 10 * i, 500 + 10 * i);
+    ASSERT_EQ(RANGE_SLIDER(w[i])->max, 1000);
+  }
+  ASSERT_EQ(RANGE_SLIDER(w[1])->view_span, 200);
+  ASSERT_TRUE(RANGE_SLIDER(w[2])->follow);
+  ASSERT_EQ(rb.cursor, wb.cursor);
+
+  /* 记录比控件多：恢复第一个，跳过其余的记录 */
+  range_slider_reset(other);
+  rbuffer_init(&rb, wb.data, wb.cursor);
+  ASSERT_EQ(range_slider_load_states(other, &rb), RET_NOT_FOUND);
+  ASSERT_RANGE(other, 0, 500);
+  ASSERT_EQ(rb.cursor, wb.cursor);
+
+  /* 控件比记录多：前三个照常恢复，多出的不修改 */
+  extra = range_slider_create(parent, 0, 120, 300, 40);
+  for (i = 0; i < 3; i++) {
+    range_slider_reset(w[i]);
+  }
+  rbuffer_init(&rb, wb.data, wb.cursor);
+  ASSERT_EQ(range_slider_load_states(parent, &rb), RET_NOT_FOUND);
+  ASSERT_EQ(rb.cursor, wb.cursor);
+  for (i = 0; i < 3; i++) {
+    ASSERT_RANGE(w[i], 10 * i, 500 + 10 * i);
+  }
+  ASSERT_RANGE(extra, 20, 50);
+  widget_destroy(extra);
+
+  /* 最后一条记录被截断或版本不对时，前面的控件也不恢复 */
+  for (i = 0; i < 3; i++) {
+    range_slider_reset(w[i]);
+  }
+  rbuffer_init(&rb, wb.data, wb.cursor - 1);
+  ASSERT_EQ(range_slider_load_states(parent, &rb), RET_BAD_PARAMS);
+  ASSERT_EQ(rb.cursor, 0u);
+  /* 每条记录为4个字节的头和7个double，把最后一条的version改为0 */
+  wb.data[wb.cursor - (4 + 7 * sizeof(double))] = 0;
+  rbuffer_init(&rb, wb.data, wb.cursor);
+  ASSERT_EQ(range_slider_load_states(parent, &rb), RET_BAD_PARAMS);
+  for (i = 0; i < 3; i++) {
+    ASSERT_RANGE(w[i], 20, 50);
+    ASSERT_EQ(RANGE_SLIDER(w[i])->max, 100);
+  }
+  ASSERT_FALSE(RANGE_SLIDER(w[2])->follow);
+  wbuffer_deinit(&wb);
+
+  widget_destroy(other);
+  widget_destroy(parent);
+}
+
+static ret_t index_label_day(void* ctx, uint32_t index, char* text, uint32_t size) {
+  (*(uint32_t*)ctx)++;
+  tk_snprintf(text, size, "D%u", index);
+  return RET_OK;
+}
+
+TEST(range_slider, index_labels) {
+  canvas_t c;
+  uint32_t calls = 0;
+  rect_t r = rect_init(0, 0, 300, 40);
+  uint8_t* fb = TKMEM_ZALLOCN(uint8_t, 300 * 40 * 4);
+  lcd_t* lcd = lcd_mem_bgra8888_create_single_fb(300, 40, fb);
+  widget_t* w = range_slider_create(NULL, 0, 0, 300, 40);
+  widget_t* label_max = NULL;
+  widget_t* label_value1 = NULL;
+
+  canvas_init(&c, lcd, font_manager());
+  canvas_begin_frame(&c, &r, LCD_DRAW_NORMAL);
+  widget_set_prop_float(w, RANGE_SLIDER_PROP_VIEW_WIDTH_RATIO, 0.8f);
+  widget_set_prop_float(w, RANGE_SLIDER_PROP_VIEW_HEIGHT_RATIO, 0.5f);
+  range_slider_set_bounds(w, 0, 999999);
+  range_slider_set_range(w, 10.4, 900000.6, FALSE);
+  widget_layout(w);
+
+  /* 一百万个类别，只为显示出来的索引生成文本 */
+  ASSERT_EQ(range_slider_set_index_labels(w, index_label_day, &calls), RET_OK);
+  ASSERT_RANGE(w, 10, 900001);
+  ASSERT_EQ(calls, 2u);
+  label_max = widget_lookup(w, RANGE_SLIDER_SUB_WIDGET_LABEL_MAX, TRUE);
+  label_value1 = widget_lookup(w, RANGE_SLIDER_SUB_WIDGET_LABEL_VALUE1, TRUE);
+  ASSERT_EQ(wstr_eq(&(label_max->text), L"D999999"), TRUE);
+
+  ASSERT_EQ(w->vt->on_paint_self(w, &c), RET_OK);
+  ASSERT_EQ(wstr_eq(&(label_value1->text), L"D10"), TRUE);
+  ASSERT_EQ(calls, 4u);
+  ASSERT_EQ(w->vt->on_paint_self(w, &c), RET_OK);
+  ASSERT_EQ(calls, 4u);
+
+  /* 来回拖动时，用过的文本从缓存中取 */
+  range_slider_set_range(w, 11, 900001, FALSE);
+  ASSERT_EQ(w->vt->on_paint_self(w, &c), RET_OK);
+  range_slider_set_range(w, 10, 900001, FALSE);
+  ASSERT_EQ(w->vt->on_paint_self(w, &c), RET_OK);
+  ASSERT_EQ(wstr_eq(&(label_value1->text), L"D10"), TRUE);
+  ASSERT_EQ(calls, 5u);
+
+  ASSERT_EQ(range_slider_set_index_labels(w, NULL, NULL), RET_OK);
+  ASSERT_EQ(wstr_eq(&(label_max->text), L"999999"), TRUE);
+  ASSERT_EQ(w->vt->on_paint_self(w, &c), RET_OK);
+  ASSERT_EQ(wstr_eq(&(label_value1->text), L"10"), TRUE);
+
+  canvas_end_frame(&c);
+  widget_destroy(w);
+  lcd_destroy(lcd);
+  TKMEM_FREE(fb);
+}
+
+TEST(range_slider, skip_invalidate_same_pixels) {
+  canvas_t c;
+  uint32_t count = 0;
+  rect_t r = rect_init(0, 0, 300, 40);
+  uint8_t* fb = TKMEM_ZALLOCN(uint8_t, 300 * 40 * 4);
+  lcd_t* lcd = lcd_mem_bgra8888_create_single_fb(300, 40, fb);
+  widget_t* w = range_slider_create(NULL, 0, 0, 300, 40);
+
+  canvas_init(&c, lcd, font_manager());
+  canvas_begin_frame(&c, &r, LCD_DRAW_NORMAL);
+  widget_set_prop_float(w, RANGE_SLIDER_PROP_VIEW_WIDTH_RATIO, 0.8f);
+  widget_set_prop_float(w, RANGE_SLIDER_PROP_VIEW_HEIGHT_RATIO, 0.5f);
+  widget_set_prop_double(w, WIDGET_PROP_STEP, 0);
+  range_slider_set_bounds(w, 0, 100000);
+  range_slider_set_range(w, 20000, 80000, FALSE);
+  widget_on(w, EVT_RANGE_CHANGED, on_range_count, &count);
+  widget_layout(w);
+  widget_paint(w, &c);
+  ASSERT_FALSE(w->dirty);
+
+  /* 滑块不动、label文本("20000")也不变，不刷新，但事件照常分发 */
+  widget_set_prop_double(w, RANGE_SLIDER_PROP_VALUE1, 20000.2);
+  ASSERT_FALSE(w->dirty);
+  ASSERT_EQ(count, 1u);
+
+  /* 文本变了 */
+  widget_set_prop_double(w, RANGE_SLIDER_PROP_VALUE1, 20001);
+  ASSERT_TRUE(w->dirty);
+  widget_paint(w, &c);
+
+  /* 不显示值label时，只看滑块的位置 */
+  widget_set_prop_bool(w, RANGE_SLIDER_PROP_VALUE_LABEL_VISIBLE, FALSE);
+  widget_layout(w);
+  widget_paint(w, &c);
+  ASSERT_FALSE(w->dirty);
+  widget_set_prop_double(w, RANGE_SLIDER_PROP_VALUE2, 80001);
+  ASSERT_FALSE(w->dirty);
+  widget_set_prop_double(w, RANGE_SLIDER_PROP_VALUE2, 90000);
+  ASSERT_TRUE(w->dirty);
+  ASSERT_EQ(count, 4u);
+
+  canvas_end_frame(&c);
+  widget_destroy(w);
+  lcd_destroy(lcd);
+  TKMEM_FREE(fb);
+}
+
+#define SNAPSHOT_READERS 4
+#define SNAPSHOT_WRITES 200000
+
+typedef struct _snapshot_reader_t {
+  range_slider_snapshot_t* snapshot;
+  volatile bool_t* done;
+  uint32_t reads;
+  uint32_t torn;
+} snapshot_reader_t;
+
+static void* snapshot_reader_entry(void* args) {
+  range_slider_range_t range;
+  snapshot_reader_t* reader = (snapshot_reader_t*)args;
+
+  do {
+    range_slider_snapshot_read(reader->snapshot, &range);
+    /* 写入的区间宽度固定为1000，读到两次写入的混合时宽度就不对了 */
+    if (range.value2 - range.value1 != 1000 || range.min != 0 || range.max != 2000) {
+      reader->torn++;
+    }
+    reader->reads++;
+  } while (!*(reader->done));
+
+  return NULL;
+}
+
+TEST(range_slider, snapshot_threads) {
+  uint32_t i = 0;
+  range_slider_range_t range;
+  range_slider_snapshot_t snapshot;
+  volatile bool_t done = FALSE;
+  tk_thread_t* threads[SNAPSHOT_READERS];
+  snapshot_reader_t readers[SNAPSHOT_READERS];
+  widget_t* w = range_slider_create(NULL, 0, 0, 300, 40);
+
+  memset(&snapshot, 0x00, sizeof(snapshot));
+  widget_set_prop_double(w, WIDGET_PROP_STEP, 1);
+  range_slider_set_bounds(w, 0, 2000);
+  range_slider_set_range(w, 0, 1000, FALSE);
+  ASSERT_EQ(range_slider_set_snapshot(w, &snapshot), RET_OK);
+  range_slider_snapshot_read(&snapshot, &range);
+  ASSERT_EQ(range.value1, 0);
+  ASSERT_EQ(range.value2, 1000);
+  ASSERT_EQ(range.max, 2000);
+
+  memset(readers, 0x00, sizeof(readers));
+  for (i = 0; i < SNAPSHOT_READERS; i++) {
+    readers[i].snapshot = &snapshot;
+    readers[i].done = &done;
+    threads[i] = tk_thread_create(snapshot_reader_entry, readers + i);
+    ASSERT_TRUE(threads[i] != NULL);
+    tk_thread_start(threads[i]);
+  }
+
+  /* GUI线程不断地改变区间，每次提交都发布一次 */
+  for (i = 0; i < SNAPSHOT_WRITES; i++) {
+    double value1 = i % 1000;
+    range_slider_set_range(w, value1, value1 + 1000, FALSE);
+  }
+
+  done = TRUE;
+  for (i = 0; i < SNAPSHOT_READERS; i++) {
+    tk_thread_join(threads[i]);
+    tk_thread_destroy(threads[i]);
+    ASSERT_GT(readers[i].reads, 0u);
+    ASSERT_EQ(readers[i].torn, 0u);
+  }
+
+  range_slider_snapshot_read(&snapshot, &range);
+  ASSERT_EQ(range.value1, (SNAPSHOT_WRITES - 1) % 1000);
+  ASSERT_EQ(range.value2, range.value1 + 1000);
+
+  widget_set_prop_double(w, WIDGET_PROP_MAX, 1500);
+  range_slider_snapshot_read(&snapshot, &range);
+  ASSERT_EQ(range.max, 1500);
+  ASSERT_EQ(range.value2, 1500);
+
+  ASSERT_EQ(range_slider_set_snapshot(w, NULL), RET_OK);
+  widget_destroy(w);
+}
+
+TEST(range_slider, value_label_auto_width) {
+  canvas_t c;
+  rect_t r = rect_init(0, 0, 400, 40);
+  uint8_t* fb = TKMEM_ZALLOCN(uint8_t, 400 * 40 * 4);
+  lcd_t* lcd = lcd_mem_bgra8888_create_single_fb(400, 40, fb);
+  widget_t* win = window_create(NULL, 0, 0, 400, 40);
+  widget_t* w = range_slider_create(win, 0, 0, 400, 40);
+  range_slider_t* range_slider = RANGE_SLIDER(w);
+  widget_t* label_value1 = NULL;
+  widget_t* label_value2 = NULL;
+  uint32_t width = 0;
+  float_t digit = 0;
+
+  canvas_init(&c, lcd, font_manager());
+  canvas_begin_frame(&c, &r, LCD_DRAW_NORMAL);
+  widget_set_prop_float(w, RANGE_SLIDER_PROP_VIEW_WIDTH_RATIO, 0.8f);
+  widget_set_prop_float(w, RANGE_SLIDER_PROP_VIEW_HEIGHT_RATIO, 0.5f);
+  widget_set_prop_int(w, RANGE_SLIDER_SUB_WIDGET_VALUE_LABEL_WIDTH, 0);
+  widget_set_prop_double(w, WIDGET_PROP_STEP, 1);
+  range_slider_set_bounds(w, 0, 100000);
+  range_slider_set_range(w, 10000, 90000, FALSE);
+  widget_layout(w);
+  label_value1 = widget_lookup(w, RANGE_SLIDER_SUB_WIDGET_LABEL_VALUE1, TRUE);
+  label_value2 = widget_lookup(w, RANGE_SLIDER_SUB_WIDGET_LABEL_VALUE2, TRUE);
+
+  ASSERT_EQ(w->vt->on_paint_self(w, &c), RET_OK);
+  if (!range_slider->label_metrics.valid) {
+    /* 没有可用的字体时测不出宽度 */
+    canvas_end_frame(&c);
+    widget_destroy(win);
+    lcd_destroy(lcd);
+    TKMEM_FREE(fb);
+    GTEST_SKIP();
+  }
+
+  /* 宽度按6位数计算，两个label一样宽 */
+  width = range_slider->label_metrics.width;
+  ASSERT_EQ(label_value1->w, (wh_t)width);
+  ASSERT_EQ(label_value2->w, (wh_t)width);
+
+  /* 范围变小后用缓存的字符宽度重新计算，不再测量 */
+  range_slider->label_metrics.digit += 0.5f;
+  digit = range_slider->label_metrics.digit;
+  range_slider_set_bounds(w, 0, 100);
+  ASSERT_EQ(w->vt->on_paint_self(w, &c), RET_OK);
+  ASSERT_EQ(range_slider->label_metrics.digit, digit);
+  ASSERT_TRUE(range_slider->label_metrics.width < width);
+  ASSERT_EQ(label_value1->w, (wh_t)range_slider->label_metrics.width);
+
+  /* 重叠时合并为一个label */
+  range_slider_set_range(w, 50, 51, FALSE);
+  ASSERT_EQ(w->vt->on_paint_self(w, &c), RET_OK);
+  ASSERT_EQ(wstr_eq(&(label_value1->text), L"50 \x2013 51"), TRUE);
+  ASSERT_EQ(label_value2->w, 0);
+
+  range_slider_set_range(w, 0, 100, FALSE);
+  ASSERT_EQ(w->vt->on_paint_self(w, &c), RET_OK);
+  ASSERT_EQ(wstr_eq(&(label_value1->text), L"0"), TRUE);
+  ASSERT_EQ(wstr_eq(&(label_value2->text), L"100"), TRUE);
+  ASSERT_EQ(label_value2->w, label_value1->w);
+
+  /* 合并后的长文本不能截断 */
+  range_slider_set_bounds(w, 0, 1e13);
+  range_slider_set_range(w, 1234567890123.0, 1234567890124.0, FALSE);
+  ASSERT_EQ(w->vt->on_paint_self(w, &c), RET_OK);
+  ASSERT_EQ(wstr_eq(&(label_value1->text), L"1234567890123 \x2013 1234567890124"), TRUE);
+  ASSERT_EQ(label_value2->w, 0);
+
+  canvas_end_frame(&c);
+  widget_destroy(win);
+  lcd_destroy(lcd);
+  TKMEM_FREE(fb);
+}